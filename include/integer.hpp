@@ -0,0 +1,103 @@
+#pragma once
+
+#include <slab_pool.hpp>
+#include <cassert>
+#include <new>
+#include <utility>
+
+// Integer classes in smart_pointers_demo, operators_demo, utility_demo and declarations_demo keep their value
+// behind int* to demonstrate ownership and move semantics: every constructor, copy and SetValue calls new
+// (SetValue even delete + new). They are deliberately not built on this header (that would remove what they
+// demonstrate); integer_allocation_demo() in smart_pointers_demo compares them with the classes below.
+// This header provides Integer as a plain value type for code which doesn't need to show ownership.
+namespace integer {
+
+// The value is stored inline, inside the object: construction, copy and SetValue never allocate and
+// copying is as cheap as copying an int.
+class Integer {
+    int value_{0};
+public:
+    Integer() = default;
+
+    Integer(int n) : value_(n) {}
+
+    int GetValue() const {
+        return value_;
+    }
+
+    void SetValue(int n) {
+        value_ = n;
+    }
+};
+
+// Slab pool of ints for cases where the value has to live on the heap (e.g. its address is handed out as int*).
+// Each thread has its own pool so no locking is needed; for the same reason a pointer must be released on
+// the thread which allocated it.
+class IntPool {
+    slab_pool::SlabPool<int, 1024> pool_;
+
+public:
+    static IntPool& Local() {
+        thread_local IntPool pool;
+        return pool;
+    }
+
+    int* Allocate(int n) {
+        return new (pool_.Allocate()) int(n);
+    }
+
+    void Deallocate(int* p) {
+        pool_.Deallocate(p);
+    }
+};
+
+// Same interface as Integer but the value is boxed: it has a stable address (Address()) which survives moves
+// of the BoxedInteger object. The int comes from the thread-local IntPool and SetValue writes in place, so
+// after the pool has warmed up none of the operations calls malloc.
+// Move takes the box, leaving the moved-from object without one: it can be assigned to or given a value with
+// SetValue (which box a new int) or destroyed; GetValue, Address and copying from it require a box.
+class BoxedInteger {
+    int* pVal_;
+public:
+    BoxedInteger(int n = 0) : pVal_(IntPool::Local().Allocate(n)) {}
+
+    BoxedInteger(const BoxedInteger& other) : pVal_(IntPool::Local().Allocate(other.GetValue())) {}
+
+    BoxedInteger(BoxedInteger&& other) noexcept : pVal_(std::exchange(other.pVal_, nullptr)) {}
+
+    BoxedInteger& operator=(const BoxedInteger& other) {
+        SetValue(other.GetValue());
+        return *this;
+    }
+
+    BoxedInteger& operator=(BoxedInteger&& other) noexcept {
+        std::swap(pVal_, other.pVal_);
+        return *this;
+    }
+
+    ~BoxedInteger() {
+        if (pVal_) {
+            IntPool::Local().Deallocate(pVal_);
+        }
+    }
+
+    int GetValue() const {
+        assert(pVal_ && "BoxedInteger has been moved from");
+        return *pVal_;
+    }
+
+    void SetValue(int n) {
+        if (pVal_) {
+            *pVal_ = n;
+        } else {
+            pVal_ = IntPool::Local().Allocate(n);
+        }
+    }
+
+    int* Address() const {
+        assert(pVal_ && "BoxedInteger has been moved from");
+        return pVal_;
+    }
+};
+
+}
@@ -1,5 +1,62 @@
 #pragma once
 
+#include <utility>
+#include <variant>
+#include <vector>
+
 namespace recursion_demo {
     void run();
+
+    //
+    // Recursion without the call stack
+    //
+    // Every recursive call takes a frame on the call stack, which is small (typically 8 MB) so deep recursion
+    // crashes with stack overflow. These helpers keep the pending work in a std::vector on the heap instead;
+    // its size is limited only by available memory and it grows by the size of the state, not of a whole frame.
+    //
+
+    // Trampoline for tail-recursive functions: step(state) returns either the final Result or the next State.
+    // The loop "bounces" from one step to the next so no frames pile up at all - memory use is constant.
+    template <typename Result, typename State, typename Step>
+    Result trampoline(State state, Step step) {
+        for (;;) {
+            std::variant<Result, State> next = step(std::move(state));
+            if (auto result = std::get_if<Result>(&next)) {
+                return std::move(*result);
+            }
+            state = std::move(std::get<State>(next));
+        }
+    }
+
+    // Linear (non-tail) recursion f(x) = is_base(x) ? base(x) : combine(x, f(next(x))).
+    // First loop descends and stores the arguments (what call frames would hold), second one unwinds and combines.
+    template <typename Arg, typename IsBase, typename Base, typename Next, typename Combine>
+    auto linear_recursion(Arg x, IsBase is_base, Base base, Next next, Combine combine) {
+        std::vector<Arg> stack;
+        while (!is_base(x)) {
+            stack.push_back(x);
+            x = next(x);
+        }
+        auto result = base(x);
+        while (!stack.empty()) {
+            result = combine(stack.back(), std::move(result));
+            stack.pop_back();
+        }
+        return result;
+    }
+
+    // Depth-first (pre-order) traversal of a tree, e.g. a directory tree.
+    // for_each_child(node, push) has to call push(child) for every child of node.
+    // Children are visited in reverse order of pushing.
+    template <typename Node, typename Visit, typename ForEachChild>
+    void depth_first(Node root, Visit visit, ForEachChild for_each_child) {
+        std::vector<Node> stack;
+        stack.push_back(std::move(root));
+        while (!stack.empty()) {
+            Node node = std::move(stack.back());
+            stack.pop_back();
+            visit(node);
+            for_each_child(node, [&stack](Node child) { stack.push_back(std::move(child)); });
+        }
+    }
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Slab allocator for pools of objects of a single type.
+namespace slab_pool {
+
+// Hands out uninitialized memory for single objects of type T. Memory is requested in slabs of slabSize slots;
+// a released slot is put into a free list (link to the next free slot is stored in the slot itself) and reused
+// by the next Allocate, so once the pool has warmed up allocating and releasing does not call malloc/free at all.
+// Not thread-safe: a pool should be used by a single thread.
+template <typename T, size_t slabSize>
+class SlabPool {
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    Slot* free_{nullptr};
+
+    void AddSlab() {
+        slabs_.emplace_back(new Slot[slabSize]);
+        Slot* slab = slabs_.back().get();
+        // Link slots in reverse so they are handed out in address order
+        for (size_t i = slabSize; i-- > 0;) {
+            slab[i].next = free_;
+            free_ = &slab[i];
+        }
+    }
+
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // memory for one T; the caller constructs the object in it
+    void* Allocate() {
+        if (free_ == nullptr) {
+            AddSlab();
+        }
+        Slot* slot = free_;
+        free_ = slot->next;
+        return slot->storage;
+    }
+
+    // p must come from Allocate() of this pool; the object in it must have been destroyed
+    void Deallocate(void* p) {
+        Slot* slot = reinterpret_cast<Slot*>(p);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    size_t Capacity() const {
+        return slabs_.size() * slabSize;
+    }
+
+    // Bulk release: returns memory of all slabs to the system at once. No memory from the pool may be in use.
+    void Release() {
+        slabs_.clear();
+        free_ = nullptr;
+    }
+};
+
+}
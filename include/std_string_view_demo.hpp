@@ -1,5 +1,13 @@
 #pragma once
 
+#include <cstddef>
+
 namespace std_string_view_demo {
     void run();
+
+    // number of calls to global operator new so far
+    size_t allocation_count();
+
+    // turns logging of allocations in operator new on/off (on by default); returns the previous setting
+    bool log_allocations(bool enable);
 }
@@ -1,10 +1,220 @@
 #include <class_demo.hpp>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <istream>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
 #include <typeinfo>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <immintrin.h>
 
 namespace class_demo {
 
+// Counter which can be updated from many threads at the same time (e.g. count of live objects changed in
+// c-tors and d-tors). A single std::atomic would be correct too but all threads would be writing to the same
+// cache line which then keeps moving between cores. Here each thread updates its own shard (in its own cache
+// line); reading the value sums all shards so it is meant for counters which are updated more often than read.
+class ShardedCounter {
+    static constexpr size_t shardCount = 16;
+
+    struct alignas(64) Shard {
+        std::atomic<int64_t> value{0};
+    };
+
+    Shard shards_[shardCount];
+
+    static size_t ShardIndex() {
+        static std::atomic<size_t> nextThread{0};
+        // threads get shards in round robin
+        thread_local size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % shardCount;
+        return index;
+    }
+
+public:
+    void Add(int64_t n) {
+        shards_[ShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    ShardedCounter& operator++() {
+        Add(1);
+        return *this;
+    }
+
+    ShardedCounter& operator--() {
+        Add(-1);
+        return *this;
+    }
+
+    int64_t Load() const {
+        int64_t sum = 0;
+        for (auto& shard : shards_) {
+            sum += shard.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+};
+
+// Unique ID generator for objects of type T which can be used from many threads. Instead of incrementing
+// a shared atomic for each ID, each thread takes a block of blockSize IDs at once and then hands them out from
+// its thread_local block without any synchronization. IDs start at 1 and are consecutive within one thread;
+// they are unique but not ordered across threads.
+template <typename T, int blockSize = 1024>
+class IdAllocator {
+    static std::atomic<int> next_;
+
+    struct Block {
+        int next{0};
+        int end{0};
+    };
+
+public:
+    static int Next() {
+        thread_local Block block;
+        if (block.next == block.end) {
+            block.next = next_.fetch_add(blockSize, std::memory_order_relaxed);
+            block.end = block.next + blockSize;
+        }
+        return block.next++;
+    }
+};
+
+template <typename T, int blockSize>
+std::atomic<int> IdAllocator<T, blockSize>::next_{1};
+
+// stream buffer which discards everything (used to silence c-tors and d-tors which print during benchmarks)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+//
+// SIMD kernels for batch operations (CarFleet, oop_demo::AccountEngine)
+//
+// The project is built without optimizations (-O0) so plain loops are not auto-vectorized. As in
+// templates_demo::simd, AVX2 versions are written with intrinsics, compiled with target("avx2") (the rest of the
+// program is compiled for the baseline x86-64 instruction set) and selected at runtime if the CPU supports AVX2.
+namespace simd {
+
+void add_scalar(float* arr, size_t size, float value) {
+    for (size_t i = 0; i < size; ++i) {
+        arr[i] += value;
+    }
+}
+
+void fill_scalar(float* arr, size_t size, float value) {
+    for (size_t i = 0; i < size; ++i) {
+        arr[i] = value;
+    }
+}
+
+void add_product_scalar(float* arr, const float* factors, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        arr[i] += factors[i] * arr[i];
+    }
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+// 8 floats per register
+__attribute__((target("avx2")))
+void add_avx2(float* arr, size_t size, float value) {
+    const __m256 v = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(arr + i, _mm256_add_ps(_mm256_loadu_ps(arr + i), v));
+    }
+    add_scalar(arr + i, size - i, value);
+}
+
+__attribute__((target("avx2")))
+void fill_avx2(float* arr, size_t size, float value) {
+    const __m256 v = _mm256_set1_ps(value);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(arr + i, v);
+    }
+    fill_scalar(arr + i, size - i, value);
+}
+
+// multiply and add are separate instructions (no FMA) so results are the same as of the scalar version
+__attribute__((target("avx2")))
+void add_product_avx2(float* arr, const float* factors, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256 a = _mm256_loadu_ps(arr + i);
+        _mm256_storeu_ps(arr + i, _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(factors + i), a)));
+    }
+    add_product_scalar(arr + i, factors + i, size - i);
+}
+
+// __builtin_cpu_supports queries CPUID; result is cached in a function-local static.
+bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// arr[i] += value
+void add(float* arr, size_t size, float value) {
+    has_avx2() ? add_avx2(arr, size, value) : add_scalar(arr, size, value);
+}
+
+// arr[i] = value
+void fill(float* arr, size_t size, float value) {
+    has_avx2() ? fill_avx2(arr, size, value) : fill_scalar(arr, size, value);
+}
+
+// arr[i] += factors[i] * arr[i]
+void add_product(float* arr, const float* factors, size_t size) {
+    has_avx2() ? add_product_avx2(arr, factors, size) : add_product_scalar(arr, factors, size);
+}
+
+#else
+
+void add(float* arr, size_t size, float value) {
+    add_scalar(arr, size, value);
+}
+
+void fill(float* arr, size_t size, float value) {
+    fill_scalar(arr, size, value);
+}
+
+void add_product(float* arr, const float* factors, size_t size) {
+    add_product_scalar(arr, factors, size);
+}
+
+#endif
+
+} // namespace simd
+
 class Car {
     // non-static data member initializers (C++11)
     // Compiler injects this initialization code into all constructors.
@@ -38,7 +248,8 @@ class Car {
     // static data member
     // Not part of the objec but part of the class.
     // Declared inside the class but defined & initialized out of class.
-    static int totalCarsCount;
+    // It's ShardedCounter rather than int so cars can be created and destroyed on many threads at the same time.
+    static ShardedCounter totalCarsCount;
 public:
 
     // Constructor.
@@ -80,6 +291,9 @@ public:
     // cause recursive calling of this same copy c-tor.
     // Const reference is used to enforce not changing other object.
     Car(const Car& other) {
+        // copy is destroyed too (and ~Car decrements the count)
+        ++totalCarsCount;
+
         // nullptr check is necessary as dereferencing nullptr will cause segmentation error in runtime.
         if (other.p_ != nullptr) {
             p_ = new int(*other.p_);
@@ -168,13 +382,13 @@ public:
     // error: static member function ‘static int class_demo::Car::GetTotalCarsCount()’ cannot have cv-qualifier
     // static int GetTotalCarsCount() const {
     static int GetTotalCarsCount() {
-        return Car::totalCarsCount;
+        return static_cast<int>(Car::totalCarsCount.Load());
     }
 };
 
 // Static member definition (memory allocation). It cannot be in class methods.
 // It is accessed via class name scope.
-int Car::totalCarsCount; // 0 by default
+ShardedCounter Car::totalCarsCount; // 0 by default
 
 void Car::FillFuel(float amount) {
     fuel_ = amount;
@@ -209,7 +423,7 @@ void Car::Dashboard() const {
     std::cout << "*p2_ = " << *p2_ << "\n";
     std::cout << "*p3_ = " << *p3_ << "\n";
     std::cout << "int1_ = " << int1_ << "\n";
-    std::cout << "Car::totalCarsCount = " << Car::totalCarsCount << "\n";
+    std::cout << "Car::totalCarsCount = " << Car::GetTotalCarsCount() << "\n";
     std::cout << std::endl;
 }
 
@@ -286,6 +500,223 @@ void copy_constructor_demo() {
     car1.Dashboard();
 }
 
+//
+// Car fleet
+//
+// Accelerate() reads and writes 8 bytes of Car (speed_ and fuel_) but Car is 64 bytes (passengers_, service
+// years, pointers to heap allocated ints...) so moving through std::vector<Car> brings a whole cache line into
+// cache for each car. CarFleet keeps each of the driving attributes of all cars in its own array (struct of
+// arrays), aligned to the cache line: AccelerateAll() streams only through fuel and speed arrays, processing
+// 8 cars per AVX2 instruction (simd::add).
+//
+class CarFleet {
+    static constexpr std::align_val_t alignment{64};
+
+    // array allocated with the given alignment
+    template <typename T>
+    struct AlignedArray {
+        T* data{};
+
+        AlignedArray() = default;
+        explicit AlignedArray(size_t size)
+            : data(static_cast<T*>(::operator new[](size * sizeof(T), alignment))) {}
+        AlignedArray(const AlignedArray&) = delete;
+        AlignedArray& operator=(const AlignedArray&) = delete;
+        AlignedArray(AlignedArray&& other) noexcept : data(std::exchange(other.data, nullptr)) {}
+        AlignedArray& operator=(AlignedArray&& other) noexcept {
+            std::swap(data, other.data);
+            return *this;
+        }
+        ~AlignedArray() {
+            ::operator delete[](data, alignment);
+        }
+    };
+
+    AlignedArray<float> fuel_;
+    AlignedArray<float> speed_;
+    AlignedArray<int> passengers_;
+    size_t size_{0};
+    size_t capacity_{0};
+
+    template <typename T>
+    void Grow(AlignedArray<T>& array, size_t capacity) {
+        AlignedArray<T> grown(capacity);
+        std::copy(array.data, array.data + size_, grown.data);
+        array = std::move(grown);
+    }
+
+public:
+    CarFleet() = default;
+
+    explicit CarFleet(size_t capacity) {
+        Reserve(capacity);
+    }
+
+    // moved-from fleet is empty
+    CarFleet(CarFleet&& other) noexcept
+        : fuel_(std::move(other.fuel_)),
+          speed_(std::move(other.speed_)),
+          passengers_(std::move(other.passengers_)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    CarFleet& operator=(CarFleet&& other) noexcept {
+        CarFleet moved(std::move(other));
+        std::swap(fuel_, moved.fuel_);
+        std::swap(speed_, moved.speed_);
+        std::swap(passengers_, moved.passengers_);
+        std::swap(size_, moved.size_);
+        std::swap(capacity_, moved.capacity_);
+        return *this;
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        Grow(fuel_, capacity);
+        Grow(speed_, capacity);
+        Grow(passengers_, capacity);
+        capacity_ = capacity;
+    }
+
+    // adds a car in the same state as Car(fuel); returns its index
+    size_t Add(float fuel = 0) {
+        if (size_ == capacity_) {
+            Reserve(std::max<size_t>(16, 2 * capacity_));
+        }
+        fuel_.data[size_] = fuel;
+        speed_.data[size_] = 0;
+        passengers_.data[size_] = 0;
+        return size_++;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    float Fuel(size_t car) const {
+        assert(car < size_);
+        return fuel_.data[car];
+    }
+
+    float Speed(size_t car) const {
+        assert(car < size_);
+        return speed_.data[car];
+    }
+
+    int Passengers(size_t car) const {
+        assert(car < size_);
+        return passengers_.data[car];
+    }
+
+    void AddPassengers(size_t car, int count) {
+        assert(car < size_);
+        passengers_.data[car] += count;
+    }
+
+    //
+    // Operations on all cars; each does what the Car member function of the same name does
+    //
+
+    void FillFuelAll(float amount) {
+        simd::fill(fuel_.data, size_, amount);
+    }
+
+    void AccelerateAll() {
+        simd::add(speed_.data, size_, 1);
+        simd::add(fuel_.data, size_, -0.5f);
+    }
+
+    void BrakeAll() {
+        simd::fill(speed_.data, size_, 0);
+    }
+
+    void Dashboard(size_t car) const {
+        std::cout << "fuel = " << Fuel(car) << "\n";
+        std::cout << "speed = " << Speed(car) << "\n";
+        std::cout << "passengers = " << Passengers(car) << "\n";
+        std::cout << std::endl;
+    }
+};
+
+void car_fleet_demo() {
+    std::cout << "car_fleet_demo()" << std::endl;
+    CarFleet fleet;
+    auto car = fleet.Add(6);
+    fleet.Add();
+    fleet.AddPassengers(car, 2);
+    fleet.AccelerateAll();
+    fleet.AccelerateAll();
+    fleet.Dashboard(car);
+    // output:
+    // fuel = 5
+    // speed = 2
+    // passengers = 2
+    fleet.BrakeAll();
+    fleet.FillFuelAll(10);
+    fleet.Dashboard(car);
+    // output:
+    // fuel = 10
+    // speed = 0
+    // passengers = 2
+    CarFleet moved = std::move(fleet);
+    std::cout << "moved.Size() = " << moved.Size() << ", fleet.Size() = " << fleet.Size() << std::endl;
+    // output: moved.Size() = 2, fleet.Size() = 0
+}
+
+// Simulates carCount cars: in each tick all cars accelerate, every 10th tick all brake and get refueled.
+// Compares std::vector<Car> (a member function call per car) with CarFleet; reports ms per tick.
+void benchmark_car_fleet() {
+    std::cout << "benchmark_car_fleet()" << std::endl;
+
+    const size_t carCount = 10000000;
+    const int ticks = 50;
+
+    auto ms_per_tick = [&](auto accelerate, auto brake, auto fill_fuel) {
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 1; tick <= ticks; ++tick) {
+            accelerate();
+            if (tick % 10 == 0) {
+                brake();
+                fill_fuel(100);
+            }
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ticks;
+    };
+
+    double carsMs;
+    {
+        // Car c-tors and d-tors print
+        NullBuffer nullBuffer;
+        auto* coutBuffer = std::cout.rdbuf(&nullBuffer);
+        std::vector<Car> cars;
+        cars.reserve(carCount);
+        for (size_t i = 0; i < carCount; ++i) {
+            cars.emplace_back(100.0f);
+        }
+        carsMs = ms_per_tick(
+            [&] { for (auto& car : cars) car.Accelerate(); },
+            [&] { for (auto& car : cars) car.Brake(); },
+            [&](float amount) { for (auto& car : cars) car.FillFuel(amount); });
+        cars.clear();
+        std::cout.rdbuf(coutBuffer);
+    }
+
+    CarFleet fleet(carCount);
+    for (size_t i = 0; i < carCount; ++i) {
+        fleet.Add(100.0f);
+    }
+    double fleetMs = ms_per_tick(
+        [&] { fleet.AccelerateAll(); },
+        [&] { fleet.BrakeAll(); },
+        [&](float amount) { fleet.FillFuelAll(amount); });
+    assert(fleet.Speed(carCount - 1) == 0 && fleet.Fuel(carCount - 1) == 100);
+
+    std::cout << carCount << " cars (sizeof(Car) = " << sizeof(Car) << "), ms per tick: std::vector<Car> = "
+        << carsMs << ", CarFleet = " << fleetMs << std::endl;
+}
+
 // all struct members are always public
 struct Point {
     int x;
@@ -882,14 +1313,20 @@ class Account {
     int id_;
     // error: ISO C++ forbids in-class initialization of non-const static member ‘class_demo::oop_demo::Account::id_generator_’
     // static int id_generator_ = 0;
-    static int id_generator_;
+    // static int id_generator_;
+    // Incrementing static int is a data race when accounts are created on multiple threads; IdAllocator is
+    // thread safe and threads don't contend for it.
+    using IdGenerator = IdAllocator<Account>;
 protected:
     float balance_{0.0f};
-public:
-    Account(const std::string& name, float balance):name_(name), balance_(balance){
-        id_ = ++Account::id_generator_;
+
+    // for accounts whose ID has already been allocated (e.g. by AccountEngine)
+    Account(const std::string& name, float balance, int id):name_(name), id_(id), balance_(balance){
         std::cout << "Account::Account()" << std::endl;
     }
+public:
+    Account(const std::string& name, float balance):Account(name, balance, IdGenerator::Next()){
+    }
 
     virtual ~Account(){
         std::cout << "Account::~Account()" << std::endl;
@@ -931,7 +1368,7 @@ public:
 
 // error: ‘static’ may not be used when defining (as opposed to declaring) a static data member [-fpermissive]
 // static int Account::id_generator_ = 0;
-int Account::id_generator_ = 0;
+// int Account::id_generator_ = 0;
 
 class Savings : public Account {
     float rate_;
@@ -1086,6 +1523,602 @@ void demo_virtual_destructors() {
     }
 }
 
+//
+// Batch account engine
+//
+// perform_transactions2() makes a virtual call for each operation on each account and Account objects (each
+// with its own std::string name) are scattered over the heap. AccountEngine stores accounts of each kind in
+// separate arrays (struct of arrays): balances of all Savings accounts are contiguous, interest rates are
+// contiguous etc. Each operation is applied to all accounts of a kind in one tight loop without virtual calls
+// or branches; deposits and interest are computed for 8 accounts per AVX2 instruction (simd::add_product).
+// Single account can still be accessed through Handle or through AccountFacade which implements Account's
+// virtual interface so code like perform_transactions2() keeps working.
+//
+class AccountEngine {
+public:
+    enum class Kind : uint8_t { Savings, Checking, Checking2 };
+
+    struct Handle {
+        Kind kind;
+        uint32_t index;
+    };
+
+    enum class WithdrawResult { Ok, InsufficientBalance, BelowMinimumBalance };
+
+private:
+    // the same minimum as Checking::minimum_balance
+    static constexpr float checkingMinimumBalance = 50;
+
+    struct Accounts {
+        std::vector<float> balances;
+        // interest rate for Savings, minimum balance for Checking and Checking2
+        std::vector<float> parameters;
+        std::vector<int> ids;
+        // not used by transactions; kept apart so it doesn't get into cache with balances
+        std::vector<std::string> names;
+    };
+
+    Accounts accounts_[3];
+
+    Accounts& Of(Kind kind) {
+        return accounts_[static_cast<size_t>(kind)];
+    }
+
+    const Accounts& Of(Kind kind) const {
+        return accounts_[static_cast<size_t>(kind)];
+    }
+
+    Handle Add(Kind kind, const std::string& name, float balance, float parameter) {
+        auto& accounts = Of(kind);
+        accounts.balances.push_back(balance);
+        accounts.parameters.push_back(parameter);
+        // IDs are unique across engine accounts and Account objects
+        accounts.ids.push_back(IdAllocator<Account>::Next());
+        accounts.names.push_back(name);
+        return {kind, static_cast<uint32_t>(accounts.balances.size() - 1)};
+    }
+
+public:
+    void Reserve(Kind kind, size_t count) {
+        auto& accounts = Of(kind);
+        accounts.balances.reserve(count);
+        accounts.parameters.reserve(count);
+        accounts.ids.reserve(count);
+        accounts.names.reserve(count);
+    }
+
+    Handle AddSavings(const std::string& name, float balance, float rate) {
+        return Add(Kind::Savings, name, balance, rate);
+    }
+
+    Handle AddChecking(const std::string& name, float balance) {
+        return Add(Kind::Checking, name, balance, checkingMinimumBalance);
+    }
+
+    Handle AddChecking2(const std::string& name, float balance, float minimumBalance) {
+        return Add(Kind::Checking2, name, balance, minimumBalance);
+    }
+
+    size_t Size(Kind kind) const {
+        return Of(kind).balances.size();
+    }
+
+    // calls visit(id, handle) for each account
+    template <typename Visit>
+    void ForEachAccount(Visit visit) const {
+        for (auto kind : {Kind::Savings, Kind::Checking, Kind::Checking2}) {
+            auto& ids = Of(kind).ids;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                visit(ids[i], Handle{kind, static_cast<uint32_t>(i)});
+            }
+        }
+    }
+
+    //
+    // Batch operations (all accounts)
+    //
+
+    void DepositAll(float amount) {
+        for (auto& accounts : accounts_) {
+            simd::add(accounts.balances.data(), accounts.balances.size(), amount);
+        }
+    }
+
+    // only Savings accounts accumulate interest
+    void AccumulateInterestAll() {
+        auto& savings = Of(Kind::Savings);
+        simd::add_product(savings.balances.data(), savings.parameters.data(), savings.balances.size());
+    }
+
+    // Rules are the same as in Account::withdraw(), Checking::withdraw() and Checking2::withdraw().
+    // Withdrawals which are not allowed are skipped; returns their number.
+    size_t WithdrawAll(float amount) {
+        size_t rejected = 0;
+        {
+            auto& savings = Of(Kind::Savings);
+            float* balances = savings.balances.data();
+            const size_t n = savings.balances.size();
+            for (size_t i = 0; i < n; ++i) {
+                bool allowed = amount < balances[i];
+                balances[i] = allowed ? balances[i] - amount : balances[i];
+                rejected += !allowed;
+            }
+        }
+        for (Kind kind : {Kind::Checking, Kind::Checking2}) {
+            auto& checking = Of(kind);
+            float* balances = checking.balances.data();
+            const float* minimumBalances = checking.parameters.data();
+            const size_t n = checking.balances.size();
+            for (size_t i = 0; i < n; ++i) {
+                bool allowed = (balances[i] - amount >= minimumBalances[i]) & (amount < balances[i]);
+                balances[i] = allowed ? balances[i] - amount : balances[i];
+                rejected += !allowed;
+            }
+        }
+        return rejected;
+    }
+
+    double TotalBalance() const {
+        double total = 0;
+        for (auto& accounts : accounts_) {
+            for (float balance : accounts.balances) {
+                total += balance;
+            }
+        }
+        return total;
+    }
+
+    //
+    // Single account operations
+    //
+
+    void Deposit(Handle account, float amount) {
+        Of(account.kind).balances[account.index] += amount;
+    }
+
+    void AccumulateInterest(Handle account) {
+        if (account.kind == Kind::Savings) {
+            auto& savings = Of(Kind::Savings);
+            savings.balances[account.index] += savings.parameters[account.index] * savings.balances[account.index];
+        }
+    }
+
+    WithdrawResult Withdraw(Handle account, float amount) {
+        auto& accounts = Of(account.kind);
+        float& balance = accounts.balances[account.index];
+        if (account.kind != Kind::Savings && balance - amount < accounts.parameters[account.index]) {
+            return WithdrawResult::BelowMinimumBalance;
+        }
+        if (amount >= balance) {
+            return WithdrawResult::InsufficientBalance;
+        }
+        balance -= amount;
+        return WithdrawResult::Ok;
+    }
+
+    float GetBalance(Handle account) const {
+        return Of(account.kind).balances[account.index];
+    }
+
+    float GetInterestRate(Handle account) const {
+        return account.kind == Kind::Savings ? Of(Kind::Savings).parameters[account.index] : 0.0f;
+    }
+
+    float GetMinimumBalance(Handle account) const {
+        return account.kind == Kind::Savings ? 0.0f : Of(account.kind).parameters[account.index];
+    }
+
+    int GetId(Handle account) const {
+        return Of(account.kind).ids[account.index];
+    }
+
+    const std::string& GetName(Handle account) const {
+        return Of(account.kind).names[account.index];
+    }
+};
+
+// Account's virtual interface over an account stored in AccountEngine, for code written against Account*.
+// get_id() returns the engine account's ID.
+// Operations are forwarded to the engine; balance_ (returned by non-virtual get_balance()) is refreshed after
+// each of them and by Sync() (needed after batch operations on the engine).
+class AccountFacade : public Account {
+    AccountEngine& engine_;
+    AccountEngine::Handle account_;
+public:
+    AccountFacade(AccountEngine& engine, AccountEngine::Handle account)
+        : Account(engine.GetName(account), engine.GetBalance(account), engine.GetId(account)), engine_(engine),
+          account_(account) {}
+
+    void Sync() {
+        balance_ = engine_.GetBalance(account_);
+    }
+
+    float get_interest_rate() const override {
+        return engine_.GetInterestRate(account_);
+    }
+
+    void accumulate_interest() override {
+        engine_.AccumulateInterest(account_);
+        Sync();
+    }
+
+    void withdraw(float amount) override {
+        switch (engine_.Withdraw(account_, amount)) {
+        case AccountEngine::WithdrawResult::Ok:
+            break;
+        case AccountEngine::WithdrawResult::InsufficientBalance:
+            std::cout << "Insufficient balance." << std::endl;
+            break;
+        case AccountEngine::WithdrawResult::BelowMinimumBalance:
+            std::cout << "Balance would go under the threshold." << std::endl;
+            break;
+        }
+        Sync();
+    }
+
+    void deposit(float amount) override {
+        engine_.Deposit(account_, amount);
+        Sync();
+    }
+};
+
+void demo_account_engine() {
+    AccountEngine engine;
+    auto savings = engine.AddSavings("Bojan", 100, 0.05f);
+    auto checking = engine.AddChecking("Bojan", 100);
+
+    // the same output as for Savings and Checking objects
+    AccountFacade savingsFacade(engine, savings);
+    perform_transactions2(&savingsFacade);
+    AccountFacade checkingFacade(engine, checking);
+    perform_transactions2(&checkingFacade);
+
+    engine.DepositAll(100);
+    savingsFacade.Sync();
+    std::cout << "Balance after DepositAll(100) = " << savingsFacade.get_balance() << std::endl;
+}
+
+// perform_transactions2() operations applied rounds times to accountsPerKind accounts of each kind through
+// virtual calls and through AccountEngine's batch operations.
+void benchmark_account_engine() {
+    std::cout << "benchmark_account_engine()" << std::endl;
+
+    const int accountsPerKind = 1000000;
+    const int rounds = 10;
+    const float initialBalance = 10000;
+    const float rate = 0.0001f;
+
+    // Account c-tors and d-tors print
+    NullBuffer nullBuffer;
+    auto* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    std::vector<std::unique_ptr<Account>> objects;
+    objects.reserve(3 * accountsPerKind);
+    AccountEngine engine;
+    for (auto kind : {AccountEngine::Kind::Savings, AccountEngine::Kind::Checking, AccountEngine::Kind::Checking2}) {
+        engine.Reserve(kind, accountsPerKind);
+    }
+    for (int i = 0; i < accountsPerKind; ++i) {
+        objects.push_back(std::make_unique<Savings>("Savings", initialBalance, rate));
+        objects.push_back(std::make_unique<Checking>("Checking", initialBalance));
+        objects.push_back(std::make_unique<Checking2>("Checking2", initialBalance, 100.0f));
+        engine.AddSavings("Savings", initialBalance, rate);
+        engine.AddChecking("Checking", initialBalance);
+        engine.AddChecking2("Checking2", initialBalance, 100.0f);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (auto& account : objects) {
+            account->deposit(100);
+            account->accumulate_interest();
+            account->withdraw(170);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double virtualMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        engine.DepositAll(100);
+        engine.AccumulateInterestAll();
+        engine.WithdrawAll(170);
+    }
+    end = std::chrono::steady_clock::now();
+    double engineMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    double virtualTotal = 0;
+    for (auto& account : objects) {
+        virtualTotal += account->get_balance();
+    }
+    objects.clear();
+    std::cout.rdbuf(coutBuffer);
+
+    assert(std::abs(virtualTotal - engine.TotalBalance()) <= 1e-6 * std::abs(virtualTotal));
+    std::cout << 3 * accountsPerKind << " accounts, " << rounds << " rounds of deposit/interest/withdraw, ms: "
+        << "virtual calls = " << virtualMs << ", AccountEngine = " << engineMs << std::endl;
+}
+
+// Each of the threads performs what Account and Car c-tors/d-tors do with shared state (get ID, increment and
+// decrement live count) opsPerThread times; returns millions of operations per second.
+template <typename Operation>
+double million_ops_per_second(unsigned threadCount, int opsPerThread, Operation operation) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < opsPerThread; ++i) {
+                operation();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return threadCount * static_cast<double>(opsPerThread) / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+struct BenchmarkTag {};
+
+void benchmark_id_allocation() {
+    std::cout << "benchmark_id_allocation()" << std::endl;
+
+    const int opsPerThread = 2000000;
+    std::atomic<int> sharedId{0};
+    std::atomic<int64_t> sharedCount{0};
+    ShardedCounter shardedCount;
+
+    std::vector<unsigned> threadCounts{1, 2, 4};
+    if (std::thread::hardware_concurrency() > 4) {
+        threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+    for (unsigned threads : threadCounts) {
+        double shared = million_ops_per_second(threads, opsPerThread, [&] {
+            sharedId.fetch_add(1, std::memory_order_relaxed);
+            sharedCount.fetch_add(1, std::memory_order_relaxed);
+            sharedCount.fetch_sub(1, std::memory_order_relaxed);
+        });
+        double sharded = million_ops_per_second(threads, opsPerThread, [&] {
+            IdAllocator<BenchmarkTag>::Next();
+            ++shardedCount;
+            --shardedCount;
+        });
+        std::cout << threads << " threads, million ops/s: std::atomic ID and count = " << shared
+            << ", IdAllocator + ShardedCounter = " << sharded << std::endl;
+    }
+    assert(sharedCount == 0 && shardedCount.Load() == 0);
+}
+
+//
+// Transaction log and batch processor
+//
+// perform_transactions2() applies a fixed sequence of operations to one account and prints after each step.
+// Transaction is one operation on one account (identified by ID); a day of activity is a log of transactions.
+// In the log (binary, for fast replay) each transaction is a fixed size record of 12 bytes:
+//      int32 account ID | uint8 type | 3 bytes padding | float32 amount
+// in host byte order.
+//
+struct Transaction {
+    enum class Type : uint8_t { Deposit, AccumulateInterest, Withdraw };
+
+    int32_t accountId;
+    Type type;
+    float amount;
+};
+
+static_assert(sizeof(Transaction) == 12, "Transaction is stored in the log as is");
+
+void WriteTransactionLog(std::ostream& os, const std::vector<Transaction>& transactions) {
+    os.write(reinterpret_cast<const char*>(transactions.data()), transactions.size() * sizeof(Transaction));
+}
+
+// Reads transactions until the end of the stream; throws if the stream ends in the middle of a record.
+std::vector<Transaction> ReadTransactionLog(std::istream& is) {
+    std::vector<Transaction> transactions;
+    Transaction transaction{};
+    while (is.read(reinterpret_cast<char*>(&transaction), sizeof(transaction))) {
+        transactions.push_back(transaction);
+    }
+    if (is.gcount() != 0) {
+        throw std::runtime_error("ReadTransactionLog: truncated record");
+    }
+    return transactions;
+}
+
+// Applies transactions to accounts in AccountEngine using multiple threads. Accounts are partitioned among
+// workers in contiguous ranges (of accounts as they're stored in the engine) so each account is updated by
+// only one worker and workers don't write to the same cache lines (except at range boundaries). A single pass
+// over the log sends each transaction to the bucket of its account's worker, keeping the log order, so each
+// account's transactions are applied in the log order: the result doesn't depend on the number of workers.
+class TransactionProcessor {
+    static constexpr uint32_t missing = UINT32_MAX;
+
+    AccountEngine& engine_;
+    // AccountEngine handle by account ID (IDs are dense)
+    std::vector<AccountEngine::Handle> accounts_;
+    // position of the first account of each kind if all accounts were in a single array
+    size_t kindOffsets_[3];
+    size_t accountCount_;
+
+    // transaction with the account already looked up
+    struct Routed {
+        AccountEngine::Handle account;
+        Transaction::Type type;
+        float amount;
+    };
+
+    // each worker writes its counts once, to its own cache line
+    struct alignas(64) WorkerResult {
+        size_t applied{0};
+        size_t rejected{0};
+    };
+
+    unsigned Owner(AccountEngine::Handle account, unsigned workerCount) const {
+        size_t position = kindOffsets_[static_cast<size_t>(account.kind)] + account.index;
+        return static_cast<unsigned>(position * workerCount / accountCount_);
+    }
+
+public:
+    struct Result {
+        size_t applied{0};
+        size_t rejected{0};
+        size_t unknownAccount{0};
+        // type byte in the log is not one of Transaction::Type values (e.g. corrupted log)
+        size_t invalidType{0};
+        double seconds{0};
+
+        double TransactionsPerSecond() const {
+            return (applied + rejected + unknownAccount + invalidType) / seconds;
+        }
+    };
+
+    explicit TransactionProcessor(AccountEngine& engine) : engine_(engine) {
+        engine_.ForEachAccount([this](int id, AccountEngine::Handle account) {
+            if (static_cast<size_t>(id) >= accounts_.size()) {
+                accounts_.resize(id + 1, AccountEngine::Handle{AccountEngine::Kind::Savings, missing});
+            }
+            accounts_[id] = account;
+        });
+        accountCount_ = 0;
+        for (auto kind : {AccountEngine::Kind::Savings, AccountEngine::Kind::Checking, AccountEngine::Kind::Checking2}) {
+            kindOffsets_[static_cast<size_t>(kind)] = accountCount_;
+            accountCount_ += engine_.Size(kind);
+        }
+    }
+
+    // workerCount 0 is treated as 1
+    Result Process(const std::vector<Transaction>& transactions, unsigned workerCount) {
+        auto start = std::chrono::steady_clock::now();
+
+        workerCount = std::max(workerCount, 1u);
+        Result total;
+        std::vector<std::vector<Routed>> buckets(workerCount);
+        for (auto& bucket : buckets) {
+            bucket.reserve(transactions.size() / workerCount + transactions.size() / 64 + 1);
+        }
+        for (const auto& transaction : transactions) {
+            if (transaction.accountId < 0 || static_cast<size_t>(transaction.accountId) >= accounts_.size()
+                || accounts_[transaction.accountId].index == missing) {
+                ++total.unknownAccount;
+                continue;
+            }
+            if (transaction.type > Transaction::Type::Withdraw) {
+                ++total.invalidType;
+                continue;
+            }
+            auto account = accounts_[transaction.accountId];
+            buckets[Owner(account, workerCount)].push_back({account, transaction.type, transaction.amount});
+        }
+
+        std::vector<WorkerResult> results(workerCount);
+        auto work = [&](unsigned worker) {
+            size_t applied = 0;
+            size_t rejected = 0;
+            for (const auto& transaction : buckets[worker]) {
+                switch (transaction.type) {
+                case Transaction::Type::Deposit:
+                    engine_.Deposit(transaction.account, transaction.amount);
+                    ++applied;
+                    break;
+                case Transaction::Type::AccumulateInterest:
+                    engine_.AccumulateInterest(transaction.account);
+                    ++applied;
+                    break;
+                case Transaction::Type::Withdraw:
+                    if (engine_.Withdraw(transaction.account, transaction.amount) == AccountEngine::WithdrawResult::Ok) {
+                        ++applied;
+                    } else {
+                        ++rejected;
+                    }
+                    break;
+                default:
+                    assert(false && "invalid types are filtered out when routing");
+                }
+            }
+            results[worker].applied = applied;
+            results[worker].rejected = rejected;
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned worker = 1; worker < workerCount; ++worker) {
+            threads.emplace_back(work, worker);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        for (auto& result : results) {
+            total.applied += result.applied;
+            total.rejected += result.rejected;
+        }
+        total.seconds = std::chrono::duration<double>(end - start).count();
+        return total;
+    }
+};
+
+std::vector<Transaction> random_transactions(const std::vector<int>& accountIds, size_t count) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> account(0, accountIds.size() - 1);
+    std::uniform_int_distribution<int> type(0, 2);
+    std::uniform_real_distribution<float> amount(1, 200);
+    // value-initialized so the padding bytes written to the log are zeros
+    std::vector<Transaction> transactions(count);
+    for (auto& transaction : transactions) {
+        transaction.accountId = accountIds[account(random)];
+        transaction.type = static_cast<Transaction::Type>(type(random));
+        transaction.amount = amount(random);
+    }
+    return transactions;
+}
+
+void benchmark_transaction_processor() {
+    std::cout << "benchmark_transaction_processor()" << std::endl;
+
+    const int accountsPerKind = 100000;
+    const size_t transactionCount = 10000000;
+
+    auto make_engine = [&] {
+        AccountEngine engine;
+        for (int i = 0; i < accountsPerKind; ++i) {
+            engine.AddSavings("Savings", 1000, 0.001f);
+            engine.AddChecking("Checking", 1000);
+            engine.AddChecking2("Checking2", 1000, 100);
+        }
+        return engine;
+    };
+    AccountEngine sequential = make_engine();
+    AccountEngine parallel = make_engine();
+
+    // Account IDs are unique so the engines have different ones; transactions are generated from the same seed
+    // so both logs contain the same operations on the corresponding accounts.
+    std::vector<int> ids;
+    sequential.ForEachAccount([&](int id, AccountEngine::Handle) { ids.push_back(id); });
+    std::vector<int> parallelIds;
+    parallel.ForEachAccount([&](int id, AccountEngine::Handle) { parallelIds.push_back(id); });
+
+    // log is written and replayed from memory
+    std::stringstream log;
+    WriteTransactionLog(log, random_transactions(ids, transactionCount));
+    auto transactions = ReadTransactionLog(log);
+    auto parallelTransactions = random_transactions(parallelIds, transactionCount);
+
+    unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    auto sequentialResult = TransactionProcessor(sequential).Process(transactions, 1);
+    auto parallelResult = TransactionProcessor(parallel).Process(parallelTransactions, workers);
+
+    // deterministic: both engines end up in the same state
+    assert(sequentialResult.applied == parallelResult.applied && sequentialResult.rejected == parallelResult.rejected);
+    assert(sequential.TotalBalance() == parallel.TotalBalance());
+
+    std::cout << transactionCount << " transactions on " << 3 * accountsPerKind << " accounts ("
+        << sequentialResult.rejected << " rejected), transactions/s: 1 worker = "
+        << sequentialResult.TransactionsPerSecond() << ", " << workers << " workers = "
+        << parallelResult.TransactionsPerSecond() << std::endl;
+}
+
 // final (C++11)
 // - Used to declare classes which cannot not be inherited.
 class MyClass final {
@@ -1340,6 +2373,9 @@ void Write(Document* pDoc) {
 // - must be overriden in derived classes. If not derived,derived class will also be an abstract one.
 class Document2 {
 public:
+    // Base classes which are used to delete derived objects (e.g. std::unique_ptr<Document2>) need virtual d-tor.
+    virtual ~Document2() = default;
+
     // Pure virtual function.
     virtual void Serialize(float version) = 0;
 };
@@ -1396,6 +2432,267 @@ void demo_abstract_class(){
     // output: XML2::Serialize()
 }
 
+//
+// Polymorphic objects without heap allocation
+//
+// Write2(Document2*) works with any document but the documents have to be created somewhere and kept alive:
+// std::vector<std::unique_ptr<Document2>> allocates each one separately on the heap and each call goes through
+// a pointer to the object and then through its vtable.
+//
+// InlinePoly<Base, Size> stores an object of any type derived from Base (up to Size bytes) inside itself
+// (small buffer): std::vector<InlinePoly<Document2, 64>> keeps all documents in one contiguous block.
+// Calls are still virtual. Each element takes Size (+16) bytes regardless of the actual object size so Size
+// should not be much bigger than the largest type stored.
+//
+// If the set of document types is closed, std::variant<Types...> can be used instead: it's also stored
+// inline and std::visit calls the function of the actual type directly (no vtable lookup; it can be inlined).
+//
+template <typename Base, size_t Size, size_t Alignment = alignof(std::max_align_t)>
+class InlinePoly {
+    struct Ops {
+        void (*destroy)(void* object);
+        void (*move)(void* destination, void* source);
+    };
+
+    template <typename T>
+    static constexpr Ops opsFor{
+        [](void* object) { static_cast<T*>(object)->~T(); },
+        [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); }
+    };
+
+    alignas(Alignment) unsigned char storage_[Size];
+    const Ops* ops_{nullptr};
+    // position of Base sub-object inside the stored object (not 0 e.g. with multiple inheritance)
+    ptrdiff_t baseOffset_{0};
+
+    void reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+public:
+    InlinePoly() = default;
+
+    template <typename T, typename... Args>
+    explicit InlinePoly(std::in_place_type_t<T>, Args&&... args) {
+        static_assert(std::is_base_of_v<Base, T>, "T must derive from Base");
+        static_assert(sizeof(T) <= Size && alignof(T) <= Alignment, "T doesn't fit into InlinePoly's buffer");
+        static_assert(std::is_nothrow_move_constructible_v<T>, "T is moved when InlinePoly is moved");
+        T* object = new (storage_) T(std::forward<Args>(args)...);
+        ops_ = &opsFor<T>;
+        baseOffset_ = reinterpret_cast<unsigned char*>(static_cast<Base*>(object)) - storage_;
+    }
+
+    InlinePoly(InlinePoly&& other) noexcept : ops_(other.ops_), baseOffset_(other.baseOffset_) {
+        if (ops_) {
+            ops_->move(storage_, other.storage_);
+        }
+    }
+
+    InlinePoly& operator=(InlinePoly&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops_) {
+                other.ops_->move(storage_, other.storage_);
+            }
+            ops_ = other.ops_;
+            baseOffset_ = other.baseOffset_;
+        }
+        return *this;
+    }
+
+    ~InlinePoly() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    Base* get() {
+        return ops_ ? std::launder(reinterpret_cast<Base*>(storage_ + baseOffset_)) : nullptr;
+    }
+
+    // like for pointers, these must not be used when empty
+    Base* operator->() {
+        return std::launder(reinterpret_cast<Base*>(storage_ + baseOffset_));
+    }
+
+    Base& operator*() {
+        return *operator->();
+    }
+};
+
+template <typename T, typename Base, size_t Size = 64, typename... Args>
+InlinePoly<Base, Size> MakeInlinePoly(Args&&... args) {
+    return InlinePoly<Base, Size>(std::in_place_type<T>, std::forward<Args>(args)...);
+}
+
+void demo_inline_poly() {
+    std::vector<InlinePoly<Document2, 64>> documents;
+    documents.push_back(MakeInlinePoly<Text2, Document2>());
+    documents.push_back(MakeInlinePoly<RichText2, Document2>());
+    documents.push_back(MakeInlinePoly<XML2, Document2>());
+    for (auto& document : documents) {
+        Write2(document.get());
+    }
+    // output:
+    // Text2::Serialize()
+    // Text2::Serialize()
+    // XML2::Serialize()
+
+    std::variant<Text2, RichText2, XML2> document = XML2{};
+    std::visit([](auto& document) { document.Serialize(1.1f); }, document);
+    // output: XML2::Serialize()
+}
+
+// Documents for the benchmark: Text2 etc. print in Serialize() which would be all that's measured.
+class BenchmarkText final : public Document2 {
+protected:
+    int words_;
+    float written_{0};
+public:
+    explicit BenchmarkText(int words) : words_(words) {}
+    void Serialize(float version) override {
+        written_ += words_ * version;
+    }
+    float Written() const {
+        return written_;
+    }
+};
+
+class BenchmarkRichText final : public Document2 {
+    int words_;
+    int styles_;
+    float written_{0};
+public:
+    BenchmarkRichText(int words, int styles) : words_(words), styles_(styles) {}
+    void Serialize(float version) override {
+        written_ += (words_ + 2 * styles_) * version;
+    }
+    float Written() const {
+        return written_;
+    }
+};
+
+class BenchmarkXML final : public Document2 {
+    int elements_;
+    int attributes_;
+    int depth_;
+    float written_{0};
+public:
+    BenchmarkXML(int elements, int attributes, int depth) : elements_(elements), attributes_(attributes), depth_(depth) {}
+    void Serialize(float version) override {
+        written_ += (3 * elements_ + attributes_ + depth_) * version;
+    }
+    float Written() const {
+        return written_;
+    }
+};
+
+template <typename T, typename... Args>
+std::unique_ptr<Document2> make_unique_document(std::in_place_type_t<T>, Args... args) {
+    return std::make_unique<T>(args...);
+}
+
+void benchmark_inline_poly() {
+    std::cout << "benchmark_inline_poly()" << std::endl;
+
+    const int count = 1000000;
+    const int rounds = 10;
+
+    // types in random order so the call target can't be predicted
+    std::mt19937 random(42);
+    std::vector<int> types(count);
+    for (auto& type : types) {
+        type = random() % 3;
+    }
+
+    auto time_ms = [](auto function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // creates documents of types in the order given by `types`: make<T>(args...) for each
+    auto create_all = [&](auto make) {
+        for (int i = 0; i < count; ++i) {
+            switch (types[i]) {
+            case 0:
+                make(std::in_place_type<BenchmarkText>, i % 100);
+                break;
+            case 1:
+                make(std::in_place_type<BenchmarkRichText>, i % 100, 3);
+                break;
+            default:
+                make(std::in_place_type<BenchmarkXML>, i % 100, 5, 2);
+                break;
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<Document2>> heapDocuments;
+    std::vector<InlinePoly<Document2, 64>> inlineDocuments;
+    using DocumentVariant = std::variant<BenchmarkText, BenchmarkRichText, BenchmarkXML>;
+    std::vector<DocumentVariant> variantDocuments;
+
+    double heapCreateMs = time_ms([&] {
+        heapDocuments.reserve(count);
+        create_all([&](auto type, auto... args) {
+            heapDocuments.push_back(make_unique_document(type, args...));
+        });
+    });
+    double inlineCreateMs = time_ms([&] {
+        inlineDocuments.reserve(count);
+        create_all([&](auto type, auto... args) {
+            inlineDocuments.emplace_back(type, args...);
+        });
+    });
+    double variantCreateMs = time_ms([&] {
+        variantDocuments.reserve(count);
+        create_all([&](auto type, auto... args) {
+            variantDocuments.emplace_back(type, args...);
+        });
+    });
+
+    double heapMs = time_ms([&] {
+        for (int round = 0; round < rounds; ++round) {
+            for (auto& document : heapDocuments) {
+                document->Serialize(1.1f);
+            }
+        }
+    });
+    double inlineMs = time_ms([&] {
+        for (int round = 0; round < rounds; ++round) {
+            for (auto& document : inlineDocuments) {
+                document->Serialize(1.1f);
+            }
+        }
+    });
+    double variantMs = time_ms([&] {
+        for (int round = 0; round < rounds; ++round) {
+            for (auto& document : variantDocuments) {
+                std::visit([](auto& document) { document.Serialize(1.1f); }, document);
+            }
+        }
+    });
+
+    double variantWritten = 0;
+    for (auto& document : variantDocuments) {
+        variantWritten += std::visit([](auto& document) { return document.Written(); }, document);
+    }
+    assert(variantWritten > 0);
+
+    // Note: here heap objects are allocated one after another so they end up next to each other in memory
+    // almost like in a vector; in a long running program they would be scattered.
+    std::cout << count << " documents, create / " << rounds << " x Serialize(), ms:" << std::endl
+        << "vector<unique_ptr<Document2>>: " << heapCreateMs << " / " << heapMs << std::endl
+        << "vector<InlinePoly<Document2, 64>>: " << inlineCreateMs << " / " << inlineMs << std::endl
+        << "vector<variant> + visit: " << variantCreateMs << " / " << variantMs << std::endl;
+}
+
 class Stream {
     std::string fileName_;
 public:
@@ -1563,6 +2860,414 @@ void multiple_inheritance_solution_demo(){
     // Stream::~Stream()
 }
 
+//
+// Buffered streams over file descriptors
+//
+// Stream/OutputStream2/InputStream2/IOStream2 above show the diamond and virtual inheritance; FdStream,
+// FdOutputStream, FdInputStream and FdIOStream have the same shape but do real I/O:
+//  - FdStream (virtual base) owns the file descriptor and a single buffer of configurable size
+//  - FdOutputStream buffers writes; Write() with several pieces (vectored write) copies them into the buffer
+//    or, if they don't fit, passes the pending buffer and all pieces to one writev() system call
+//  - FdInputStream reads into the buffer; Peek() returns a view of buffered bytes (no copy) and Consume()
+//    skips them
+//  - FdIOStream: thanks to virtual inheritance there's only one FdStream and so one descriptor and one buffer
+//    used for both directions: switching from writing to reading flushes it; switching from reading to
+//    writing discards the read-ahead and moves file position back to the first byte not consumed
+// Errors are reported by throwing std::system_error.
+//
+class FdStream {
+    enum class Mode { Idle, Reading, Writing };
+
+    std::string fileName_;
+    int fd_;
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    Mode mode_{Mode::Idle};
+    // Reading: buffer_[readPos_, end_) are bytes read but not consumed yet
+    // Writing: buffer_[0, end_) are bytes not written to the file yet
+    size_t readPos_{0};
+    size_t end_{0};
+
+protected:
+    [[noreturn]] void ThrowError(const char* operation) const {
+        // building the message allocates (and the allocation may be logged) which can change errno
+        int error = errno;
+        throw std::system_error(error, std::generic_category(), std::string(operation) + " " + fileName_);
+    }
+
+    // O_CLOEXEC: the descriptor is not inherited by programs started with exec()
+    FdStream(const std::string& fileName, int flags, size_t bufferSize)
+        : fileName_(fileName), fd_(::open(fileName.c_str(), flags | O_CLOEXEC, 0644)), buffer_(new char[bufferSize]),
+          capacity_(bufferSize) {
+        if (fd_ < 0) {
+            ThrowError("open");
+        }
+    }
+
+    // writes all iovecs, continuing after partial writes
+    void WriteAll(iovec* pieces, int count) {
+        while (count > 0) {
+            ssize_t written = ::writev(fd_, pieces, std::min(count, IOV_MAX));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ThrowError("write");
+            }
+            while (count > 0 && static_cast<size_t>(written) >= pieces->iov_len) {
+                written -= pieces->iov_len;
+                ++pieces;
+                --count;
+            }
+            if (count > 0) {
+                pieces->iov_base = static_cast<char*>(pieces->iov_base) + written;
+                pieces->iov_len -= written;
+            }
+        }
+    }
+
+    void FlushWrites() {
+        if (mode_ == Mode::Writing && end_ > 0) {
+            iovec pending{buffer_.get(), end_};
+            WriteAll(&pending, 1);
+        }
+        if (mode_ == Mode::Writing) {
+            end_ = 0;
+            mode_ = Mode::Idle;
+        }
+    }
+
+    // Unread bytes are given back to the file by moving its position back.
+    void DiscardReads() {
+        if (mode_ != Mode::Reading) {
+            return;
+        }
+        if (readPos_ < end_ && ::lseek(fd_, -static_cast<off_t>(end_ - readPos_), SEEK_CUR) < 0) {
+            ThrowError("seek (unread input would be lost)");
+        }
+        readPos_ = end_ = 0;
+        mode_ = Mode::Idle;
+    }
+
+    // Returns free space in the buffer for writing.
+    std::pair<char*, size_t> WriteSpace() {
+        if (mode_ != Mode::Writing) {
+            DiscardReads();
+            mode_ = Mode::Writing;
+        }
+        return {buffer_.get() + end_, capacity_ - end_};
+    }
+
+    void Commit(size_t bytes) {
+        end_ += bytes;
+    }
+
+    // pending bytes were written by the caller
+    void ClearPending() {
+        assert(mode_ == Mode::Writing);
+        end_ = 0;
+    }
+
+    size_t Pending() const {
+        return mode_ == Mode::Writing ? end_ : 0;
+    }
+
+    char* Buffer() {
+        return buffer_.get();
+    }
+
+    // Makes at least `bytes` (up to buffer capacity) buffered for reading unless end of file is reached first.
+    std::string_view ReadWindow(size_t bytes) {
+        if (mode_ != Mode::Reading) {
+            FlushWrites();
+            mode_ = Mode::Reading;
+        }
+        bytes = std::min(bytes, capacity_);
+        if (end_ - readPos_ < bytes) {
+            // move unconsumed bytes to the beginning and fill the rest
+            std::memmove(buffer_.get(), buffer_.get() + readPos_, end_ - readPos_);
+            end_ -= readPos_;
+            readPos_ = 0;
+            while (end_ < bytes) {
+                ssize_t n = ::read(fd_, buffer_.get() + end_, capacity_ - end_);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    ThrowError("read");
+                }
+                if (n == 0) {
+                    break;
+                }
+                end_ += n;
+            }
+        }
+        return {buffer_.get() + readPos_, end_ - readPos_};
+    }
+
+    void Advance(size_t bytes) {
+        assert(mode_ == Mode::Reading && bytes <= end_ - readPos_);
+        readPos_ += bytes;
+    }
+
+    // reads directly into destination, bypassing the buffer (which must be empty)
+    size_t ReadDirect(char* destination, size_t size) {
+        assert(mode_ != Mode::Reading || readPos_ == end_);
+        ssize_t n;
+        do {
+            n = ::read(fd_, destination, size);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) {
+            ThrowError("read");
+        }
+        return static_cast<size_t>(n);
+    }
+
+public:
+    FdStream(const FdStream&) = delete;
+    FdStream& operator=(const FdStream&) = delete;
+
+    virtual ~FdStream() {
+        ::close(fd_);
+    }
+
+    const std::string& GetFileName() const {
+        return fileName_;
+    }
+
+    size_t BufferSize() const {
+        return capacity_;
+    }
+
+    // flushes pending output and moves to the given position
+    void Seek(off_t position) {
+        FlushWrites();
+        DiscardReads();
+        if (::lseek(fd_, position, SEEK_SET) < 0) {
+            ThrowError("seek");
+        }
+    }
+};
+
+class FdOutputStream : virtual public FdStream {
+public:
+    explicit FdOutputStream(const std::string& fileName, size_t bufferSize = 64 * 1024)
+        : FdStream(fileName, O_WRONLY | O_CREAT | O_TRUNC, bufferSize) {}
+
+    ~FdOutputStream() override {
+        try {
+            Flush();
+        } catch (const std::system_error&) {
+            // d-tor must not throw; call Flush() explicitly to get the error
+        }
+    }
+
+    void Flush() {
+        FlushWrites();
+    }
+
+    void Write(std::string_view data) {
+        Write({data});
+    }
+
+    // Vectored write: all pieces are written in order, with at most one system call when they don't fit
+    // into the buffer.
+    void Write(std::initializer_list<std::string_view> pieces) {
+        size_t total = 0;
+        for (auto piece : pieces) {
+            total += piece.size();
+        }
+        auto [space, free] = WriteSpace();
+        if (total <= free) {
+            for (auto piece : pieces) {
+                std::memcpy(space, piece.data(), piece.size());
+                space += piece.size();
+            }
+            Commit(total);
+            return;
+        }
+        // small enough to fit into the (empty) buffer: flush and buffer them
+        if (total <= BufferSize()) {
+            Flush();
+            Write(pieces);
+            return;
+        }
+        std::vector<iovec> iovecs;
+        iovecs.reserve(pieces.size() + 1);
+        if (Pending() > 0) {
+            iovecs.push_back({Buffer(), Pending()});
+        }
+        for (auto piece : pieces) {
+            iovecs.push_back({const_cast<char*>(piece.data()), piece.size()});
+        }
+        WriteAll(iovecs.data(), static_cast<int>(iovecs.size()));
+        ClearPending();
+    }
+
+    FdOutputStream& operator<<(std::string_view data) {
+        Write(data);
+        return *this;
+    }
+};
+
+class FdInputStream : virtual public FdStream {
+public:
+    explicit FdInputStream(const std::string& fileName, size_t bufferSize = 64 * 1024)
+        : FdStream(fileName, O_RDONLY, bufferSize) {}
+
+    // Up to `bytes` of the next bytes in the stream (fewer only at the end of file or if `bytes` is bigger than
+    // the buffer), without copying them: the view is valid until the next operation on the stream.
+    std::string_view Peek(size_t bytes) {
+        return ReadWindow(bytes);
+    }
+
+    // skips bytes returned by Peek()
+    void Consume(size_t bytes) {
+        Advance(bytes);
+    }
+
+    // Copies up to size bytes into destination; returns 0 at the end of file.
+    size_t Read(char* destination, size_t size) {
+        size_t copied = 0;
+        auto buffered = ReadWindow(0);
+        if (!buffered.empty()) {
+            copied = std::min(size, buffered.size());
+            std::memcpy(destination, buffered.data(), copied);
+            Advance(copied);
+        }
+        if (copied < size) {
+            // large reads go directly into the destination
+            if (size - copied >= BufferSize()) {
+                copied += ReadDirect(destination + copied, size - copied);
+            } else {
+                auto window = ReadWindow(size - copied);
+                size_t n = std::min(size - copied, window.size());
+                std::memcpy(destination + copied, window.data(), n);
+                Advance(n);
+                copied += n;
+            }
+        }
+        return copied;
+    }
+
+    // Reads the next line (without '\n'); returns false at the end of file.
+    bool ReadLine(std::string& line) {
+        line.clear();
+        for (;;) {
+            auto window = Peek(BufferSize());
+            if (window.empty()) {
+                return !line.empty();
+            }
+            auto newline = window.find('\n');
+            if (newline != std::string_view::npos) {
+                line.append(window.data(), newline);
+                Consume(newline + 1);
+                return true;
+            }
+            line.append(window.data(), window.size());
+            Consume(window.size());
+        }
+    }
+};
+
+// One descriptor (opened for reading and writing) and one buffer for both directions.
+class FdIOStream : public FdOutputStream, public FdInputStream {
+public:
+    // Only the most derived class constructs virtual base; FdStream initialization in FdOutputStream and
+    // FdInputStream c-tors is skipped so the file is opened once.
+    explicit FdIOStream(const std::string& fileName, size_t bufferSize = 64 * 1024)
+        : FdStream(fileName, O_RDWR | O_CREAT | O_TRUNC, bufferSize), FdOutputStream(fileName, bufferSize),
+          FdInputStream(fileName, bufferSize) {}
+};
+
+void demo_fd_streams() {
+    auto path = (std::filesystem::temp_directory_path() / "fd_streams_demo.txt").string();
+    {
+        FdIOStream stream(path, 16);
+        stream << "first line\n";
+        stream.Write({"second", " ", "line\n"});
+        stream.Seek(0);
+
+        std::string line;
+        stream.ReadLine(line);
+        std::cout << "Line: " << line << std::endl;
+        // output: Line: first line
+
+        // peek without consuming
+        std::cout << "Next 6 bytes: " << stream.Peek(6).substr(0, 6) << std::endl;
+        // output: Next 6 bytes: second
+
+        // switching to writing puts the read-ahead back: this is appended after "second "
+        stream.Consume(7);
+        stream << "LINE\n";
+        stream.Seek(0);
+        while (stream.ReadLine(line)) {
+            std::cout << "Line: " << line << std::endl;
+        }
+        // output:
+        // Line: first line
+        // Line: second LINE
+    }
+    std::filesystem::remove(path);
+}
+
+// Writes records (8-byte header + payload) and reads them back through FdOutputStream/FdInputStream and through
+// std::ofstream/std::ifstream; reports MB/s.
+void benchmark_fd_streams() {
+    std::cout << "benchmark_fd_streams()" << std::endl;
+
+    const size_t recordCount = 1000000;
+    const std::string payload(92, 'x');
+    const char header[8] = {'R', 'E', 'C', 'O', 'R', 'D', ':', ' '};
+    const double megabytes = recordCount * (sizeof(header) + payload.size()) / (1024.0 * 1024.0);
+    auto path = (std::filesystem::temp_directory_path() / "fd_streams_benchmark.bin").string();
+
+    auto mb_per_s = [&](auto function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        return megabytes / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double fdWrite = mb_per_s([&] {
+        FdOutputStream out(path);
+        for (size_t i = 0; i < recordCount; ++i) {
+            out.Write({std::string_view(header, sizeof(header)), payload});
+        }
+        out.Flush();
+    });
+    size_t fdBytes = 0;
+    double fdRead = mb_per_s([&] {
+        FdInputStream in(path);
+        const size_t recordSize = sizeof(header) + payload.size();
+        for (auto record = in.Peek(recordSize); !record.empty(); record = in.Peek(recordSize)) {
+            fdBytes += record.size();
+            in.Consume(record.size());
+        }
+    });
+
+    double fstreamWrite = mb_per_s([&] {
+        std::ofstream out(path, std::ios::binary);
+        for (size_t i = 0; i < recordCount; ++i) {
+            out.write(header, sizeof(header));
+            out.write(payload.data(), payload.size());
+        }
+    });
+    size_t fstreamBytes = 0;
+    double fstreamRead = mb_per_s([&] {
+        std::ifstream in(path, std::ios::binary);
+        char record[100];
+        while (in.read(record, sizeof(record)) || in.gcount() > 0) {
+            fstreamBytes += in.gcount();
+        }
+    });
+    std::filesystem::remove(path);
+
+    assert(fdBytes == fstreamBytes && fdBytes == recordCount * (sizeof(header) + payload.size()));
+    std::cout << megabytes << " MB in " << recordCount << " records, MB/s (write / read): "
+        << "FdOutputStream/FdInputStream = " << fdWrite << " / " << fdRead
+        << ", std::ofstream/std::ifstream = " << fstreamWrite << " / " << fstreamRead << std::endl;
+}
+
 } // namespace oop_demo
 
 
@@ -1571,6 +3276,8 @@ void run() {
     // class_demo();
     // struct_demo();
     // copy_constructor_demo();
+    // car_fleet_demo();
+    // benchmark_car_fleet();
     // delegating_constructors_demo();
     // default_and_deleted_member_functions_demo();
     // friend_demo();
@@ -1578,12 +3285,20 @@ void run() {
     // oop_demo::demo();
     // oop_demo::demo_account();
     // oop_demo::demo_virtual_destructors();
+    // oop_demo::demo_account_engine();
+    // oop_demo::benchmark_account_engine();
+    // oop_demo::benchmark_id_allocation();
+    // oop_demo::benchmark_transaction_processor();
     // oop_demo::demo_overriding();
     // oop_demo::demo_RTTI();
     // oop_demo::demo_abstract_class();
+    // oop_demo::demo_inline_poly();
+    // oop_demo::benchmark_inline_poly();
     // oop_demo::multiple_inheritance_demo();
     // oop_demo::multiple_inheritance_demo2();
     oop_demo::multiple_inheritance_solution_demo();
+    // oop_demo::demo_fd_streams();
+    // oop_demo::benchmark_fd_streams();
 }
 
 }
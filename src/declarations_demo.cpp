@@ -1,6 +1,10 @@
 #include <declarations_demo.hpp>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <typeinfo>
 
 namespace {
@@ -346,6 +350,148 @@ void fibonacci_demo() {
     constexpr int n2 = fibonacci(11);
 }
 
+//
+// Compile-time lookup tables
+//
+// factorial() and fibonacci() above are evaluated at compile time only when the result is needed in a constant
+// expression; called with a runtime argument they recompute everything (fibonacci even in exponential time).
+// As their domain is tiny (int overflows at 13! and fib(47)) we can compute all results once, at compile time,
+// and store them in a std::array. A runtime call then becomes a single indexed load.
+//
+// make_table works for any constexpr function: std::array and its operator[] are constexpr (C++17) so
+// the loop is executed by the compiler when the result initializes a constexpr variable.
+template <size_t N, typename F>
+constexpr auto make_table(F f) {
+    std::array<decltype(f(size_t{0})), N> table{};
+    for (size_t i = 0; i < N; ++i) {
+        table[i] = f(i);
+    }
+    return table;
+}
+
+// Overflow-checked arithmetic. throw is not allowed in a constant expression so overflow at compile time is
+// a compile error; at runtime it's an exception.
+template <typename T>
+constexpr T checked_add(T a, T b) {
+    if (a > std::numeric_limits<T>::max() - b) {
+        throw std::overflow_error("checked_add");
+    }
+    return a + b;
+}
+
+template <typename T>
+constexpr T checked_mul(T a, T b) {
+    if (b != 0 && a > std::numeric_limits<T>::max() / b) {
+        throw std::overflow_error("checked_mul");
+    }
+    return a * b;
+}
+
+template <typename T>
+constexpr T factorial_checked(size_t n) {
+    T result = 1;
+    for (size_t i = 2; i <= n; ++i) {
+        result = checked_mul(result, static_cast<T>(i));
+    }
+    return result;
+}
+
+// Iterative: O(n) instead of exponential recursion
+template <typename T>
+constexpr T fibonacci_checked(size_t n) {
+    T previous = 0;
+    T current = 1;
+    if (n == 0) {
+        return previous;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        T next = checked_add(previous, current);
+        previous = current;
+        current = next;
+    }
+    return current;
+}
+
+// Largest n for which n! fits into T (20 for 64-bit, 34 for 128-bit)
+template <typename T>
+constexpr size_t factorial_limit() {
+    T result = 1;
+    size_t n = 1;
+    while (result <= std::numeric_limits<T>::max() / (n + 1)) {
+        result *= n + 1;
+        ++n;
+    }
+    return n;
+}
+
+// Largest n for which fib(n) fits into T (93 for 64-bit, 186 for 128-bit)
+template <typename T>
+constexpr size_t fibonacci_limit() {
+    T previous = 0;
+    T current = 1;
+    size_t n = 1;
+    while (previous <= std::numeric_limits<T>::max() - current) {
+        T next = previous + current;
+        previous = current;
+        current = next;
+        ++n;
+    }
+    return n;
+}
+
+template <typename T>
+constexpr auto factorial_table = make_table<factorial_limit<T>() + 1>([](size_t n) { return factorial_checked<T>(n); });
+
+template <typename T>
+constexpr auto fibonacci_table = make_table<fibonacci_limit<T>() + 1>([](size_t n) { return fibonacci_checked<T>(n); });
+
+template <typename T>
+T factorial_lut(size_t n) {
+    if (n >= factorial_table<T>.size()) {
+        throw std::overflow_error("factorial_lut");
+    }
+    return factorial_table<T>[n];
+}
+
+template <typename T>
+T fibonacci_lut(size_t n) {
+    if (n >= fibonacci_table<T>.size()) {
+        throw std::overflow_error("fibonacci_lut");
+    }
+    return fibonacci_table<T>[n];
+}
+
+void lookup_table_demo() {
+    static_assert(factorial_table<uint64_t>.size() == 21, "20! is the largest factorial which fits 64 bits");
+    static_assert(factorial_table<uint64_t>[20] == 2432902008176640000ULL, "");
+    static_assert(fibonacci_table<uint64_t>.size() == 94, "fib(93) is the largest Fibonacci number which fits 64 bits");
+    static_assert(fibonacci_table<uint64_t>[93] == 12200160415121876738ULL, "");
+
+    // Tables agree with the constexpr functions above
+    static_assert(factorial_table<uint64_t>[12] == factorial(12), "");
+    static_assert(fibonacci_table<uint64_t>[20] == fibonacci(20), "");
+
+    // unsigned __int128 is a GCC/Clang extension
+#if defined(__SIZEOF_INT128__)
+    static_assert(factorial_table<unsigned __int128>.size() == 35, "");
+    static_assert(fibonacci_table<unsigned __int128>.size() == 187, "");
+    std::cout << "34! mod 2^64 = " << static_cast<uint64_t>(factorial_lut<unsigned __int128>(34)) << std::endl;
+#endif
+
+    unsigned n = 20;
+    std::cout << "factorial_lut(" << n << ") = " << factorial_lut<uint64_t>(n) << std::endl;
+    std::cout << "fibonacci_lut(90) = " << fibonacci_lut<uint64_t>(90) << std::endl;
+
+    try {
+        factorial_lut<uint64_t>(21);
+    } catch (const std::overflow_error& e) {
+        std::cout << "21! does not fit into 64 bits: " << e.what() << std::endl;
+    }
+
+    // error: expression '<throw-expression>' is not a constant expression
+    // constexpr auto tooBig = factorial_checked<uint64_t>(21);
+}
+
 void auto_demo() {
 
     // For variables, 'auto' specifies that the type of the variable that is being declared
@@ -892,6 +1038,7 @@ void run(){
     // decltype_auto_functions_demo();
     // factorial_demo();
     // fibonacci_demo();
+    // lookup_table_demo();
     // namespace_demo();
     // lvalues_rvalues_demo();
     // rvalue_reference_demo();
@@ -1,4 +1,5 @@
 #include <filesystem_demo.hpp>
+#include <recursion_demo.hpp>
 #include <iostream>
 #include <cassert>
 #include <filesystem>
@@ -55,10 +56,44 @@ void directory_iterator_demo(){
     }
 }
 
+//
+// Recursive directory listing
+//
+// Walking a directory tree is naturally recursive but deep trees could overflow the call stack.
+// depth_first() from recursion_demo keeps the directories which are still to be listed in a heap allocated stack.
+// (std::filesystem::recursive_directory_iterator is another non-recursive option.)
+//
+void recursive_listing_demo() {
+    size_t files = 0;
+    size_t directories = 0;
+
+    recursion_demo::depth_first(current_path(),
+        [&](const path& p) {
+            ++directories;
+            std::cout << p << std::endl;
+        },
+        [&](const path& p, auto push) {
+            // e.g. permission denied; skip such directories (or the rest of them) instead of throwing.
+            // Range-for would call operator++ which throws so the iterator is advanced with increment(ec).
+            std::error_code ec;
+            for (directory_iterator it{p, ec}, end; !ec && it != end; it.increment(ec)) {
+                std::error_code entryEc;
+                if (it->is_directory(entryEc) && !it->is_symlink(entryEc)) {
+                    push(it->path());
+                } else {
+                    ++files;
+                }
+            }
+        });
+
+    std::cout << "directories: " << directories << ", files: " << files << std::endl;
+}
+
 void run() {
     std::cout << "filesystem_demo::run()" << std::endl;
     path_demo();
     directory_iterator_demo();
+    // recursive_listing_demo();
 }
 
 }
@@ -1,5 +1,19 @@
 #include <recursion_demo.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace recursion_demo {
 
@@ -18,9 +32,717 @@ namespace recursion_demo {
         std::cout << "factorial(5) = " << factorial(5) << std::endl;
     }
 
+    //
+    // Arbitrary-precision unsigned integer
+    //
+    // factorial() above overflows unsigned int at 13!. BigUnsigned stores a number of any size as a vector of
+    // "digits" in base 10^9 (least significant first). Base 10^9 is the largest power of 10 for which a product of
+    // two digits plus carry fits into 64 bits, and converting to decimal string is trivial.
+    //
+    // Multiplication of n-digit numbers:
+    // - schoolbook: every digit by every digit, O(n^2); fastest for small numbers
+    // - Karatsuba: splits both numbers in halves, a = a1*B^m + a0, b = b1*B^m + b0, and computes the product
+    //   with 3 half-size multiplications instead of 4:
+    //      a*b = z2*B^2m + z1*B^m + z0, z2 = a1*b1, z0 = a0*b0, z1 = (a0+a1)(b0+b1) - z2 - z0
+    //   Applied recursively this gives O(n^1.585). Below karatsubaThreshold digits the recursion falls back to
+    //   schoolbook multiplication as the bookkeeping costs more than it saves.
+    // - number-theoretic transform (NTT): the product's digits are the convolution of the operands' digits, which
+    //   an FFT computes in O(n log n). NTT is an FFT with arithmetic modulo a prime instead of complex numbers so
+    //   it is exact. A column of the convolution can be up to n * base^2 which needs more bits than one 30-bit
+    //   prime has, so it is done modulo three primes and the columns are recovered with the Chinese remainder
+    //   theorem. Used from nttThreshold digits (of the shorter number) up, as long as the transform is not longer
+    //   than nttMaxLength; larger products are split by Karatsuba until the parts fit.
+    class BigUnsigned {
+        using Digits = std::vector<uint32_t>;
+        static constexpr uint32_t base = 1000000000;
+        static constexpr size_t karatsubaThreshold = 64;
+        static constexpr size_t nttThreshold = 1024;
+        // The transform length must divide p - 1 for all three primes: 998244353 = 119 * 2^23 + 1 has roots of
+        // unity only for lengths up to 2^23.
+        static constexpr size_t nttMaxLength = size_t{1} << 23;
+
+        Digits digits_; // empty means zero
+
+        static void trim(Digits& d) {
+            while (!d.empty() && d.back() == 0) {
+                d.pop_back();
+            }
+        }
+
+        // r += x * base^shift
+        static void add_shifted(Digits& r, const Digits& x, size_t shift) {
+            if (r.size() < x.size() + shift) {
+                r.resize(x.size() + shift, 0);
+            }
+            uint32_t carry = 0;
+            size_t i = 0;
+            for (; i < x.size() || carry; ++i) {
+                if (shift + i == r.size()) {
+                    r.push_back(0);
+                }
+                uint32_t sum = r[shift + i] + carry + (i < x.size() ? x[i] : 0);
+                carry = sum >= base;
+                r[shift + i] = carry ? sum - base : sum;
+            }
+        }
+
+        // r -= x; requires r >= x
+        static void subtract(Digits& r, const Digits& x) {
+            int64_t borrow = 0;
+            for (size_t i = 0; i < r.size(); ++i) {
+                int64_t diff = static_cast<int64_t>(r[i]) - borrow - (i < x.size() ? x[i] : 0);
+                borrow = diff < 0;
+                r[i] = static_cast<uint32_t>(borrow ? diff + base : diff);
+                if (i >= x.size() && !borrow) {
+                    break;
+                }
+            }
+            assert(borrow == 0);
+            trim(r);
+        }
+
+        // Column sums are accumulated in 64 bits and carries are propagated only every carryInterval rows: a
+        // product of two digits is below 10^18 so a column can take that many of them on top of a normalized value
+        // (< base) without overflowing. The inner loop is then a plain multiply-add which the compiler vectorizes.
+        static constexpr size_t carryInterval = 16;
+
+        static void propagate_carries(std::vector<uint64_t>& columns) {
+            uint64_t carry = 0;
+            for (auto& column : columns) {
+                uint64_t cur = column + carry;
+                column = cur % base;
+                carry = cur / base;
+            }
+            assert(carry == 0);
+        }
+
+        static Digits multiply_schoolbook(const Digits& a, const Digits& b) {
+            std::vector<uint64_t> columns(a.size() + b.size(), 0);
+            for (size_t i = 0; i < a.size(); ++i) {
+                const uint64_t ai = a[i];
+                uint64_t* column = columns.data() + i;
+                for (size_t j = 0; j < b.size(); ++j) {
+                    column[j] += ai * b[j];
+                }
+                if ((i + 1) % carryInterval == 0) {
+                    propagate_carries(columns);
+                }
+            }
+            propagate_carries(columns);
+            Digits r(columns.begin(), columns.end());
+            trim(r);
+            return r;
+        }
+
+        static constexpr uint32_t nttPrimes[3] = {998244353, 167772161, 469762049}; // c * 2^k + 1, 3 is a generator
+
+        template <uint32_t mod>
+        static uint32_t pow_mod(uint64_t x, uint64_t exponent) {
+            uint64_t r = 1;
+            for (x %= mod; exponent > 0; exponent >>= 1, x = x * x % mod) {
+                if (exponent & 1) {
+                    r = r * x % mod;
+                }
+            }
+            return static_cast<uint32_t>(r);
+        }
+
+        // In-place iterative transform; a.size() must be a power of two. mod is a template parameter so % is
+        // compiled into multiplications instead of a division instruction.
+        template <uint32_t mod>
+        static void ntt(std::vector<uint32_t>& a, bool inverse) {
+            const size_t n = a.size();
+            for (size_t i = 1, j = 0; i < n; ++i) {
+                size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1) {
+                    j ^= bit;
+                }
+                j ^= bit;
+                if (i < j) {
+                    std::swap(a[i], a[j]);
+                }
+            }
+            std::vector<uint32_t> roots(n / 2);
+            for (size_t length = 2; length <= n; length <<= 1) {
+                uint64_t root = pow_mod<mod>(3, (mod - 1) / length);
+                if (inverse) {
+                    root = pow_mod<mod>(root, mod - 2);
+                }
+                roots[0] = 1;
+                for (size_t k = 1; k < length / 2; ++k) {
+                    roots[k] = static_cast<uint32_t>(roots[k - 1] * root % mod);
+                }
+                for (size_t i = 0; i < n; i += length) {
+                    for (size_t k = 0; k < length / 2; ++k) {
+                        uint32_t u = a[i + k];
+                        uint32_t v = static_cast<uint32_t>(static_cast<uint64_t>(a[i + k + length / 2]) * roots[k] % mod);
+                        a[i + k] = u + v < mod ? u + v : u + v - mod;
+                        a[i + k + length / 2] = u >= v ? u - v : u + mod - v;
+                    }
+                }
+            }
+            if (inverse) {
+                uint64_t nInverse = pow_mod<mod>(n, mod - 2);
+                for (auto& x : a) {
+                    x = static_cast<uint32_t>(x * nInverse % mod);
+                }
+            }
+        }
+
+        // convolution of a and b modulo mod, of size n (power of two)
+        template <uint32_t mod>
+        static std::vector<uint32_t> convolution(const Digits& a, const Digits& b, size_t n) {
+            std::vector<uint32_t> fa(n, 0), fb(n, 0);
+            for (size_t i = 0; i < a.size(); ++i) {
+                fa[i] = a[i] % mod;
+            }
+            for (size_t i = 0; i < b.size(); ++i) {
+                fb[i] = b[i] % mod;
+            }
+            ntt<mod>(fa, false);
+            ntt<mod>(fb, false);
+            for (size_t i = 0; i < n; ++i) {
+                fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * fb[i] % mod);
+            }
+            ntt<mod>(fa, true);
+            return fa;
+        }
+
+        static Digits multiply_ntt(const Digits& a, const Digits& b) {
+            constexpr uint64_t p0 = nttPrimes[0], p1 = nttPrimes[1], p2 = nttPrimes[2];
+            // columns must be below p0 * p1 * p2 (~7.8e25); each is at most min(size) * base^2
+            assert(std::min(a.size(), b.size()) < 50000000);
+
+            size_t n = 1;
+            while (n < a.size() + b.size()) {
+                n <<= 1;
+            }
+            assert(n <= nttMaxLength);
+            auto r0 = convolution<nttPrimes[0]>(a, b, n);
+            auto r1 = convolution<nttPrimes[1]>(a, b, n);
+            auto r2 = convolution<nttPrimes[2]>(a, b, n);
+
+            // Garner's algorithm: x = x0 + p0 * t1 + p0 * p1 * t2
+            const uint64_t p0InverseModP1 = pow_mod<nttPrimes[1]>(p0, p1 - 2);
+            const uint64_t p0p1InverseModP2 = pow_mod<nttPrimes[2]>(p0 * p1 % p2, p2 - 2);
+            Digits r(a.size() + b.size(), 0);
+            // unsigned __int128 is a GCC/Clang extension
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 carry = 0;
+            for (size_t i = 0; i < r.size(); ++i) {
+                uint64_t t1 = (r1[i] + p1 - r0[i] % p1) % p1 * p0InverseModP1 % p1;
+                uint64_t x01 = r0[i] + p0 * t1; // < p0 * p1
+                uint64_t t2 = (r2[i] + p2 - x01 % p2) % p2 * p0p1InverseModP2 % p2;
+                unsigned __int128 column = x01 + static_cast<unsigned __int128>(p0 * p1) * t2 + carry;
+                r[i] = static_cast<uint32_t>(column % base);
+                carry = column / base;
+            }
+#else
+            // column = x01 + p0 * p1 * t2 + carry doesn't fit into 64 bits but column / base does, so the low digit
+            // and the carry are computed from the parts split at base
+            constexpr uint64_t p0p1 = p0 * p1;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < r.size(); ++i) {
+                uint64_t t1 = (r1[i] + p1 - r0[i] % p1) % p1 * p0InverseModP1 % p1;
+                uint64_t x01 = r0[i] + p0 * t1; // < p0 * p1
+                uint64_t t2 = (r2[i] + p2 - x01 % p2) % p2 * p0p1InverseModP2 % p2;
+                uint64_t low = x01 % base + p0p1 % base * t2 + carry % base;
+                r[i] = static_cast<uint32_t>(low % base);
+                carry = low / base + x01 / base + p0p1 / base * t2 + carry / base;
+            }
+#endif
+            assert(carry == 0);
+            trim(r);
+            return r;
+        }
+
+        static Digits multiply(const Digits& a, const Digits& b) {
+            if (a.empty() || b.empty()) {
+                return {};
+            }
+            if (std::min(a.size(), b.size()) < karatsubaThreshold) {
+                return multiply_schoolbook(a, b);
+            }
+            if (std::min(a.size(), b.size()) >= nttThreshold && a.size() + b.size() <= nttMaxLength) {
+                return multiply_ntt(a, b);
+            }
+            if (a.size() < b.size()) {
+                return multiply(b, a);
+            }
+            if (a.size() >= 2 * b.size()) {
+                // Unbalanced: splitting both at half of the longer one would leave b1 empty and multiply b twice.
+                // Instead a is cut into b-sized chunks and each chunk is multiplied by b.
+                Digits r;
+                for (size_t i = 0; i < a.size(); i += b.size()) {
+                    Digits chunk(a.begin() + i, a.begin() + std::min(i + b.size(), a.size()));
+                    trim(chunk);
+                    add_shifted(r, multiply(chunk, b), i);
+                }
+                trim(r);
+                return r;
+            }
+
+            // b is the shorter one so both of its halves are non-empty
+            size_t m = b.size() / 2;
+            auto low = [m](const Digits& x) {
+                Digits d(x.begin(), x.begin() + std::min(m, x.size()));
+                trim(d);
+                return d;
+            };
+            auto high = [m](const Digits& x) {
+                return x.size() > m ? Digits(x.begin() + m, x.end()) : Digits{};
+            };
+
+            Digits a0 = low(a), a1 = high(a), b0 = low(b), b1 = high(b);
+            Digits z0 = multiply(a0, b0);
+            Digits z2 = multiply(a1, b1);
+            add_shifted(a0, a1, 0);
+            add_shifted(b0, b1, 0);
+            Digits z1 = multiply(a0, b0);
+            subtract(z1, z0);
+            subtract(z1, z2);
+
+            Digits r = std::move(z0);
+            add_shifted(r, z1, m);
+            add_shifted(r, z2, 2 * m);
+            trim(r);
+            return r;
+        }
+
+    public:
+        BigUnsigned(uint64_t n = 0) {
+            while (n > 0) {
+                digits_.push_back(static_cast<uint32_t>(n % base));
+                n /= base;
+            }
+        }
+
+        BigUnsigned& operator+=(const BigUnsigned& other) {
+            add_shifted(digits_, other.digits_, 0);
+            return *this;
+        }
+
+        // *this must not be less than other
+        BigUnsigned& operator-=(const BigUnsigned& other) {
+            subtract(digits_, other.digits_);
+            return *this;
+        }
+
+        friend BigUnsigned operator+(BigUnsigned a, const BigUnsigned& b) {
+            return a += b;
+        }
+
+        friend BigUnsigned operator-(BigUnsigned a, const BigUnsigned& b) {
+            return a -= b;
+        }
+
+        friend BigUnsigned operator*(const BigUnsigned& a, const BigUnsigned& b) {
+            BigUnsigned r;
+            r.digits_ = multiply(a.digits_, b.digits_);
+            return r;
+        }
+
+        bool operator==(const BigUnsigned& other) const {
+            return digits_ == other.digits_;
+        }
+
+        // Number of decimal digits
+        size_t DecimalDigits() const {
+            if (digits_.empty()) {
+                return 1;
+            }
+            return (digits_.size() - 1) * 9 + std::to_string(digits_.back()).size();
+        }
+
+        std::string ToString() const {
+            if (digits_.empty()) {
+                return "0";
+            }
+            std::string s = std::to_string(digits_.back());
+            for (size_t i = digits_.size() - 1; i-- > 0;) {
+                std::string digit = std::to_string(digits_[i]);
+                s.append(9 - digit.size(), '0');
+                s += digit;
+            }
+            return s;
+        }
+    };
+
+    // Product lo * (lo + 1) * ... * hi by binary splitting.
+    // Multiplying the running product by the next small number (as factorial() does) multiplies a huge number by
+    // a tiny one n times. Splitting the range in halves recursively multiplies numbers of similar size instead,
+    // which is where Karatsuba pays off.
+    BigUnsigned product(uint64_t lo, uint64_t hi) {
+        if (hi - lo < 8) {
+            BigUnsigned r{lo};
+            for (uint64_t i = lo + 1; i <= hi; ++i) {
+                r = r * BigUnsigned{i};
+            }
+            return r;
+        }
+        uint64_t mid = lo + (hi - lo) / 2;
+        return product(lo, mid) * product(mid + 1, hi);
+    }
+
+    BigUnsigned big_factorial(uint64_t n) {
+        return n < 2 ? BigUnsigned{1} : product(2, n);
+    }
+
+    // Fast doubling:
+    //      F(2k)   = F(k) * (2*F(k+1) - F(k))
+    //      F(2k+1) = F(k)^2 + F(k+1)^2
+    // Walking the bits of n from the most significant one needs only O(log n) steps.
+    BigUnsigned big_fibonacci(uint64_t n) {
+        BigUnsigned a{0}; // F(k)
+        BigUnsigned b{1}; // F(k+1)
+        for (int bit = 63; bit >= 0; --bit) {
+            BigUnsigned c = a * (b + b - a);
+            BigUnsigned d = a * a + b * b;
+            if ((n >> bit) & 1) {
+                a = d;
+                b = c + d;
+            } else {
+                a = c;
+                b = d;
+            }
+        }
+        return a;
+    }
+
+    void big_integer_demo() {
+        assert(big_factorial(20).ToString() == "2432902008176640000");
+        assert(big_factorial(25).ToString() == "15511210043330985984000000");
+        assert(big_fibonacci(100).ToString() == "354224848179261915075");
+
+        std::cout << "30! = " << big_factorial(30).ToString() << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        auto f = big_factorial(100000);
+        auto mid = std::chrono::steady_clock::now();
+        auto fib = big_fibonacci(1000000);
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << "100000! has " << f.DecimalDigits() << " digits, computed in "
+            << std::chrono::duration<double, std::milli>(mid - start).count() << " ms" << std::endl;
+        std::cout << "fib(1000000) has " << fib.DecimalDigits() << " digits, computed in "
+            << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
+    }
+
+
+    //
+    // Memoization
+    //
+    // A pure function always returns the same result for the same arguments so results can be cached.
+    // Naive recursive fibonacci calls itself twice per level and recomputes the same values over and over (O(2^n));
+    // with a cache every fib(k) is computed once (O(n)).
+    //
+    // For the recursive calls to hit the cache they have to go through the memoized wrapper, so a recursive
+    // function receives the wrapper as its first parameter (self) and calls self(n - 1) instead of itself.
+    // Functions which don't take self are memoized too (only the top-level call is cached then).
+    //
+    // Cache is a fixed-size open addressing hash table: entries live in one contiguous array and a key is looked up
+    // in up to maxProbe consecutive slots starting from its hash (linear probing), which stays within a cache line or
+    // two. If all of them are taken, the entry in the first slot is evicted so memory use is bounded.
+    // Keys and values have to be default constructible.
+    //
+    // Sharded mode is thread-safe: table is split into shards, each with its own mutex, and a key always goes to the
+    // same shard so threads working on different keys rarely wait for each other. The lock is not held while the
+    // function is computed (it may call self recursively); two threads may then compute the same value, which is
+    // harmless for a pure function.
+    template <typename Key, typename Value>
+    class BoundedCache {
+        static constexpr size_t maxProbe = 8;
+
+        struct Entry {
+            Key key{};
+            Value value{};
+            bool occupied{false};
+        };
+
+        std::vector<Entry> entries_;
+        size_t mask_;
+
+    public:
+        // capacity is rounded up to a power of 2 so slot index is hash & mask
+        explicit BoundedCache(size_t capacity) {
+            size_t size = maxProbe;
+            while (size < capacity) {
+                size *= 2;
+            }
+            entries_.resize(size);
+            mask_ = size - 1;
+        }
+
+        const Value* Find(const Key& key, size_t hash) const {
+            for (size_t i = 0; i < maxProbe; ++i) {
+                const Entry& e = entries_[(hash + i) & mask_];
+                if (!e.occupied) {
+                    return nullptr;
+                }
+                if (e.key == key) {
+                    return &e.value;
+                }
+            }
+            return nullptr;
+        }
+
+        void Insert(const Key& key, size_t hash, const Value& value) {
+            Entry* target = &entries_[hash & mask_];
+            for (size_t i = 0; i < maxProbe; ++i) {
+                Entry& e = entries_[(hash + i) & mask_];
+                if (!e.occupied || e.key == key) {
+                    target = &e;
+                    break;
+                }
+            }
+            target->key = key;
+            target->value = value;
+            target->occupied = true;
+        }
+    };
+
+    template <typename Signature, typename F, bool Sharded>
+    class Memoized;
+
+    template <typename R, typename... Args, typename F, bool Sharded>
+    class Memoized<R(Args...), F, Sharded> {
+        using Key = std::tuple<std::decay_t<Args>...>;
+        using Counter = std::conditional_t<Sharded, std::atomic<size_t>, size_t>;
+        static constexpr size_t shardCount = Sharded ? 16 : 1;
+
+        struct Shard {
+            BoundedCache<Key, R> cache;
+            std::mutex mutex;
+            explicit Shard(size_t capacity) : cache(capacity) {}
+        };
+
+        F f_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        Counter hits_{0};
+        Counter misses_{0};
+
+        static size_t hash(const Key& key) {
+            size_t h = 0;
+            std::apply([&h](const auto&... xs) {
+                ((h = h * 31 + std::hash<std::decay_t<decltype(xs)>>{}(xs)), ...);
+            }, key);
+            // std::hash of integers is identity; mix bits so that shard index and slot index are independent
+            return h * 0x9E3779B97F4A7C15ull;
+        }
+
+        Shard& shard_for(size_t h) {
+            return *shards_[(h >> 48) % shardCount];
+        }
+
+        std::optional<R> find(Shard& shard, const Key& key, size_t h) {
+            if constexpr (Sharded) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                const R* value = shard.cache.Find(key, h);
+                return value ? std::optional<R>{*value} : std::nullopt;
+            } else {
+                const R* value = shard.cache.Find(key, h);
+                return value ? std::optional<R>{*value} : std::nullopt;
+            }
+        }
+
+        void insert(Shard& shard, const Key& key, size_t h, const R& value) {
+            if constexpr (Sharded) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.cache.Insert(key, h, value);
+            } else {
+                shard.cache.Insert(key, h, value);
+            }
+        }
+
+    public:
+        Memoized(F f, size_t capacity) : f_(std::move(f)) {
+            for (size_t i = 0; i < shardCount; ++i) {
+                shards_.push_back(std::make_unique<Shard>(capacity / shardCount));
+            }
+        }
+
+        R operator()(Args... args) {
+            Key key{args...};
+            size_t h = hash(key);
+            Shard& shard = shard_for(h);
+
+            if (auto cached = find(shard, key, h)) {
+                ++hits_;
+                return *cached;
+            }
+            ++misses_;
+
+            R result = [&] {
+                if constexpr (std::is_invocable<F&, Memoized&, Args...>::value) {
+                    return f_(*this, args...);
+                } else {
+                    return f_(args...);
+                }
+            }();
+            insert(shard, key, h, result);
+            return result;
+        }
+
+        size_t Hits() const {
+            return hits_;
+        }
+
+        size_t Misses() const {
+            return misses_;
+        }
+    };
+
+    // Usage: auto fib = memoize<uint64_t(unsigned)>([](auto& self, unsigned n) -> uint64_t { ... self(n - 1) ... });
+    template <typename Signature, bool Sharded = false, typename F>
+    Memoized<Signature, F, Sharded> memoize(F f, size_t capacity = 1024) {
+        return Memoized<Signature, F, Sharded>(std::move(f), capacity);
+    }
+
+    void memoization_demo() {
+        // Same definition as declarations_demo's fibonacci, only the recursive calls go through self
+        auto fibonacci = memoize<uint64_t(unsigned)>([](auto& self, unsigned n) -> uint64_t {
+            return n <= 1 ? n : self(n - 1) + self(n - 2);
+        });
+
+        std::cout << "fibonacci(90) = " << fibonacci(90) << std::endl; // 2880067194370816120
+        // Without memoization this would take ~10^19 calls. Each fib(k) is computed once: 91 misses, 88 hits.
+        std::cout << "hits = " << fibonacci.Hits() << ", misses = " << fibonacci.Misses() << std::endl;
+
+        auto memoizedFactorial = memoize<unsigned(unsigned)>(factorial);
+        memoizedFactorial(10);
+        memoizedFactorial(10);
+        std::cout << "factorial: hits = " << memoizedFactorial.Hits() << ", misses = " << memoizedFactorial.Misses() << std::endl;
+
+        // Function of two arguments - number of paths in a grid from (0, 0) to (r, c)
+        auto paths = memoize<uint64_t(unsigned, unsigned), true>([](auto& self, unsigned r, unsigned c) -> uint64_t {
+            return r == 0 || c == 0 ? 1 : self(r - 1, c) + self(r, c - 1);
+        }, 4096);
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < 4; ++t) {
+            threads.emplace_back([&paths, t] {
+                paths(30 + t, 30);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << "paths(30, 30) = " << paths(30, 30) << std::endl; // 118264581564861424
+        std::cout << "paths: hits = " << paths.Hits() << ", misses = " << paths.Misses() << std::endl;
+    }
+
+    //
+    // Explicit stack vs native recursion
+    //
+
+    struct TreeNode {
+        int value;
+        std::vector<std::unique_ptr<TreeNode>> children;
+    };
+
+    std::unique_ptr<TreeNode> make_tree(int depth, int branching, int& counter) {
+        auto node = std::make_unique<TreeNode>();
+        node->value = counter++;
+        if (depth > 0) {
+            for (int i = 0; i < branching; ++i) {
+                node->children.push_back(make_tree(depth - 1, branching, counter));
+            }
+        }
+        return node;
+    }
+
+    long long tree_sum_recursive(const TreeNode* node) {
+        long long sum = node->value;
+        for (const auto& child : node->children) {
+            sum += tree_sum_recursive(child.get());
+        }
+        return sum;
+    }
+
+    long long tree_sum_explicit(const TreeNode* root) {
+        long long sum = 0;
+        depth_first(root,
+            [&sum](const TreeNode* node) { sum += node->value; },
+            [](const TreeNode* node, auto push) {
+                for (const auto& child : node->children) {
+                    push(child.get());
+                }
+            });
+        return sum;
+    }
+
+    // factorial() modulo a prime so it can be called with any n. (With wrap-around, i.e. mod 2^64, n! would be 0
+    // for every n >= 66 and comparing results of the implementations below would prove nothing.)
+    const uint64_t factorialModulus = 1000000007;
+
+    uint64_t factorial_mod_recursive(uint64_t n) {
+        return n == 0 ? 1 : n * factorial_mod_recursive(n - 1) % factorialModulus;
+    }
+
+    uint64_t factorial_mod_linear(uint64_t n) {
+        return linear_recursion(n,
+            [](uint64_t x) { return x == 0; },
+            [](uint64_t) { return uint64_t{1}; },
+            [](uint64_t x) { return x - 1; },
+            [](uint64_t x, uint64_t result) { return x * result % factorialModulus; });
+    }
+
+    // Tail-recursive form: factorial(n, acc) = n == 0 ? acc : factorial(n - 1, acc * n)
+    uint64_t factorial_mod_trampoline(uint64_t n) {
+        using State = std::pair<uint64_t, uint64_t>; // (n, acc)
+        return trampoline<uint64_t>(State{n, 1}, [](State s) -> std::variant<uint64_t, State> {
+            if (s.first == 0) {
+                return s.second;
+            }
+            return State{s.first - 1, s.second * s.first % factorialModulus};
+        });
+    }
+
+    template <typename F>
+    double time_ms(F f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    void explicit_stack_demo() {
+        uint64_t n = 10000;
+        uint64_t r1 = 0, r2 = 0, r3 = 0;
+        auto recursive = time_ms([&] { for (int i = 0; i < 100; ++i) r1 += factorial_mod_recursive(n + i); });
+        auto linear = time_ms([&] { for (int i = 0; i < 100; ++i) r2 += factorial_mod_linear(n + i); });
+        auto trampolined = time_ms([&] { for (int i = 0; i < 100; ++i) r3 += factorial_mod_trampoline(n + i); });
+        assert(r1 == r2 && r2 == r3 && r1 != 0);
+        std::cout << "factorial: recursive " << recursive << " ms, explicit stack " << linear
+            << " ms, trampoline " << trampolined << " ms" << std::endl;
+
+        int counter = 0;
+        auto tree = make_tree(12, 3, counter); // ~800k nodes
+        long long s1 = 0, s2 = 0;
+        auto recursiveTree = time_ms([&] { s1 = tree_sum_recursive(tree.get()); });
+        auto explicitTree = time_ms([&] { s2 = tree_sum_explicit(tree.get()); });
+        assert(s1 == s2);
+        std::cout << "tree sum: recursive " << recursiveTree << " ms, explicit stack " << explicitTree << " ms" << std::endl;
+
+        // 100 million levels would need gigabytes of call stack; here it's a loop.
+        // sum_to(n, acc) = n == 0 ? acc : sum_to(n - 1, acc + n)
+        using State = std::pair<uint64_t, uint64_t>;
+        auto sum = trampoline<uint64_t>(State{100000000, 0}, [](State s) -> std::variant<uint64_t, State> {
+            if (s.first == 0) {
+                return s.second;
+            }
+            return State{s.first - 1, s.second + s.first};
+        });
+        std::cout << "sum_to(100000000) = " << sum << std::endl; // 5000000050000000
+        // Segmentation fault (stack overflow):
+        // factorial_mod_recursive(100000000);
+    }
 
     void run() {
         std::cout << "recursion_demo::run()" << std::endl;
         factorial_demo();
+        // big_integer_demo();
+        // memoization_demo();
+        // explicit_stack_demo();
     }
 }
@@ -1,7 +1,24 @@
 #include <smart_pointers_demo.hpp>
+#include <integer.hpp>
+#include <slab_pool.hpp>
+#include <std_string_view_demo.hpp>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace smart_pointers_demo {
 
@@ -339,6 +356,7 @@ void operate_with_unique_ptr(int n) {
 // - it has an explicit c-tor => we cannot use assignment to initialize it; we need to use direct initialization
 // - it supports move semantics (move c-tor and assignment operators are defined) => we can move the resource ownership
 // - after it's been moved, this pointer should not be used
+// - custom deleter can return memory to where it came from (see arena_ptr_demo::ArenaPtr)
 void demo() {
     std::cout << "unique_ptr::demo()" << std::endl;
     std::unique_ptr<Integer> p(new Integer);
@@ -492,6 +510,8 @@ void demo() {
     //      Segmentation fault (core dumped)
     // p0->SetValue(1);
 
+    // shared_ptr constructed from new T allocates the control block separately (2 allocations);
+    // std::make_shared<Integer>() allocates object and control block together (see intrusive_ptr_demo).
     std::shared_ptr<Integer> p(new Integer);
     p->SetValue(1);
     assert((*p).GetValue() == 1);
@@ -641,6 +661,9 @@ public:
     }
 };
 
+// expired() and lock() are atomic operations on the shared control block; for read-mostly resources with many
+// reader threads see epoch_reclamation_demo::Printer3.
+
 void solution(){
     std::cout << "weak_ptr::solution()" << std::endl;
 
@@ -772,6 +795,1405 @@ void demo() {
 }
 }
 
+// Heap allocations made by Integer (pointer to int; every c-tor and SetValue allocates) compared to
+// integer::Integer (value stored inline) and integer::BoxedInteger (value in a thread-local pool).
+template <typename TInteger>
+size_t count_allocations(int iterations) {
+    size_t before = std_string_view_demo::allocation_count();
+    for (int i = 0; i < iterations; ++i) {
+        TInteger a(i);
+        TInteger b;
+        b = a;
+        a.SetValue(i + 1);
+        assert(b.GetValue() == i);
+    }
+    return std_string_view_demo::allocation_count() - before;
+}
+
+// smart_pointers_demo::Integer prints from its constructors; discard that output while measuring.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+// Redirects std::cout to NullBuffer and turns off logging in operator new (which would otherwise be part of
+// each measured allocation) for the lifetime of the object.
+class SilencedOutput {
+    NullBuffer nullBuffer_;
+    std::streambuf* coutBuffer_;
+    bool logAllocations_;
+public:
+    SilencedOutput()
+        : coutBuffer_(std::cout.rdbuf(&nullBuffer_)), logAllocations_(std_string_view_demo::log_allocations(false)) {}
+    SilencedOutput(const SilencedOutput&) = delete;
+    SilencedOutput& operator=(const SilencedOutput&) = delete;
+    ~SilencedOutput() {
+        std_string_view_demo::log_allocations(logAllocations_);
+        std::cout.rdbuf(coutBuffer_);
+    }
+};
+
+void integer_allocation_demo() {
+    const int iterations = 100000;
+    size_t pointerInteger, inlineInteger, boxedInteger;
+    {
+        SilencedOutput silenced;
+        pointerInteger = count_allocations<Integer>(iterations);
+        inlineInteger = count_allocations<integer::Integer>(iterations);
+        boxedInteger = count_allocations<integer::BoxedInteger>(iterations);
+    }
+
+    std::cout << "allocations for " << iterations << " iterations: "
+        << "Integer = " << pointerInteger               // 400000
+        << ", integer::Integer = " << inlineInteger     // 0
+        << ", integer::BoxedInteger = " << boxedInteger // 2 (first slab of the pool and its bookkeeping)
+        << std::endl;
+}
+
+namespace intrusive_ptr_demo {
+
+//
+// IntrusivePtr<T, Count>
+//
+// std::shared_ptr<T>(new T) makes two allocations (object and control block) and each copy of shared_ptr does
+// an atomic increment and decrement of the count in the control block. std::make_shared puts both in one
+// allocation but the control block still holds two atomic counts (strong and weak) and a deleter and
+// shared_ptr itself is two pointers large.
+//
+// IntrusivePtr keeps the count next to the object, in the same allocation (MakeIntrusive()), has no weak
+// count and is the size of a single pointer. How the count is updated is selected by Count policy:
+//  - AtomicCount: like shared_ptr; copies can be made and destroyed on any thread
+//  - LocalCount: non-atomic; for objects which never leave the thread which created them
+//  - BiasedCount: biased reference counting: the thread which created the object (the owner) updates its own
+//    non-atomic count; other threads update a separate atomic count
+//
+
+class AtomicCount {
+    std::atomic<uint32_t> count_{1};
+public:
+    void Acquire() {
+        // a new reference can only be made from an existing one so nothing needs to be ordered here
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // returns true when the last reference was released
+    bool Release() {
+        return count_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    uint32_t UseCount() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+};
+
+class LocalCount {
+    uint32_t count_{1};
+public:
+    void Acquire() {
+        ++count_;
+    }
+
+    bool Release() {
+        return --count_ == 0;
+    }
+
+    uint32_t UseCount() const {
+        return count_;
+    }
+};
+
+// Total count is biased_ + shared count. References are counted in biased_ when they are created or released
+// on the owner thread and in shared_ otherwise. When biased_ drops to 0 the owner merges: it sets the merged bit
+// in shared_ and from then on all threads (including the owner) use shared_ only. The object is released by
+// whoever brings shared count to 0 after the merge.
+// A reference created on the owner thread can be released on another thread. While shared count is above 0 the
+// release just decrements it (references are interchangeable). When it is 0 all remaining references are counted
+// in biased_ which only the owner can read, so the release is deferred to the owner (the full algorithm lets
+// shared count go negative and queues the object; here the queued release keeps the object alive instead). The
+// owner applies deferred releases - merges the count and then releases - when one of its objects merges and when
+// the owner thread exits. If the owner has already exited, the releasing thread merges the count itself.
+class BiasedCount {
+    static constexpr int64_t one = 2;
+    static constexpr int64_t merged = 1;
+
+    // Unlike std::thread::id, never reused by a thread started later.
+    static uint64_t ThisThread() {
+        static std::atomic<uint64_t> next{0};
+        thread_local const uint64_t id = ++next;
+        return id;
+    }
+
+    class OwnerThread;
+
+    // owner threads which are alive, by ThisThread()
+    struct Owners {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, OwnerThread*> threads;
+    };
+
+    static Owners& owners() {
+        static Owners instance;
+        return instance;
+    }
+
+    // Releases deferred to one owner thread. Registered on the thread's first BiasedCount.
+    class OwnerThread {
+        // guarded by owners().mutex
+        std::vector<BiasedCount*> deferred_;
+        std::atomic<bool> hasDeferred_{false};
+
+    public:
+        OwnerThread() {
+            std::lock_guard<std::mutex> lock(owners().mutex);
+            owners().threads[ThisThread()] = this;
+        }
+
+        ~OwnerThread() {
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(owners().mutex);
+                    if (deferred_.empty()) {
+                        owners().threads.erase(ThisThread());
+                        return;
+                    }
+                }
+                ApplyDeferred();
+            }
+        }
+
+        // called with owners().mutex locked
+        void Defer(BiasedCount* count) {
+            deferred_.push_back(count);
+            hasDeferred_.store(true, std::memory_order_relaxed);
+        }
+
+        // Deleting an object can release (and defer) other references so counts are taken out of the queue first.
+        void ApplyDeferred() {
+            if (!hasDeferred_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::vector<BiasedCount*> counts;
+            {
+                std::lock_guard<std::mutex> lock(owners().mutex);
+                counts.swap(deferred_);
+                hasDeferred_.store(false, std::memory_order_relaxed);
+            }
+            for (auto count : counts) {
+                if (count->MergeAndRelease()) {
+                    assert(count->deleter_ && "deferred release needs SetDeleter()");
+                    count->deleter_(count->object_);
+                }
+            }
+        }
+    };
+
+    static OwnerThread& ThisOwnerThread() {
+        thread_local OwnerThread ownerThread;
+        return ownerThread;
+    }
+
+    // owner-only fields
+    const uint64_t owner_{ThisThread()};
+    uint32_t biased_{1};
+    bool merged_{false};
+    // deletes the object when a deferred release was the last one
+    void* object_{nullptr};
+    void (*deleter_)(void*){nullptr};
+    // shared count * 2 + merged bit
+    // On its own cache line so other threads' updates don't slow down the owner's.
+    alignas(64) std::atomic<int64_t> shared_{0};
+
+    bool IsOwner() const {
+        // merged_ must not be read by other threads
+        return owner_ == ThisThread() && !merged_;
+    }
+
+    // Only on the owner thread or, under owners().mutex, after the owner has exited. Moves biased_ to shared_
+    // (unless already merged) and releases a deferred reference; returns true if it was the last one.
+    bool MergeAndRelease() {
+        if (!merged_) {
+            merged_ = true;
+            shared_.fetch_add(biased_ * one + merged, std::memory_order_acq_rel);
+            biased_ = 0;
+        }
+        return shared_.fetch_sub(one, std::memory_order_acq_rel) == one + merged;
+    }
+
+    // Release on another thread when shared count is 0; returns true if the object must be deleted now.
+    bool Defer() {
+        std::lock_guard<std::mutex> lock(owners().mutex);
+        auto owner = owners().threads.find(owner_);
+        if (owner != owners().threads.end()) {
+            owner->second->Defer(this);
+            return false;
+        }
+        // the owner has exited so it won't touch biased_ again; the mutex orders this with other deferred releases
+        return MergeAndRelease();
+    }
+
+public:
+    BiasedCount() {
+        ThisOwnerThread();
+    }
+
+    void SetDeleter(void* object, void (*deleter)(void*)) {
+        object_ = object;
+        deleter_ = deleter;
+    }
+
+    void Acquire() {
+        if (IsOwner()) {
+            ++biased_;
+        } else {
+            shared_.fetch_add(one, std::memory_order_relaxed);
+        }
+    }
+
+    bool Release() {
+        if (IsOwner()) {
+            if (--biased_ > 0) {
+                return false;
+            }
+            merged_ = true;
+            auto old = shared_.fetch_add(merged, std::memory_order_acq_rel);
+            ThisOwnerThread().ApplyDeferred();
+            return old == 0;
+        }
+        auto old = shared_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (old & merged) {
+                return shared_.fetch_sub(one, std::memory_order_acq_rel) == one + merged;
+            }
+            if (old == 0) {
+                return Defer();
+            }
+            // not merged so biased_ > 0: this can't be the last reference
+            if (shared_.compare_exchange_weak(old, old - one, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+    }
+
+    // must be called on the owner thread; exact only when no other thread is changing the count
+    uint32_t UseCount() const {
+        auto shared = shared_.load(std::memory_order_relaxed);
+        return static_cast<uint32_t>((merged_ ? 0 : biased_) + (shared - (shared & merged)) / one);
+    }
+};
+
+template <typename T, typename Count = AtomicCount>
+class IntrusivePtr {
+    struct Node {
+        Count count;
+        T value;
+
+        template <typename... Args>
+        explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {
+            if constexpr (std::is_same<Count, BiasedCount>::value) {
+                count.SetDeleter(this, [](void* node) { delete static_cast<Node*>(node); });
+            }
+        }
+    };
+
+    Node* node_{nullptr};
+
+    explicit IntrusivePtr(Node* node) : node_(node) {}
+
+    template <typename U, typename C, typename... Args>
+    friend IntrusivePtr<U, C> MakeIntrusive(Args&&... args);
+
+public:
+    IntrusivePtr() = default;
+
+    IntrusivePtr(const IntrusivePtr& other) : node_(other.node_) {
+        if (node_) {
+            node_->count.Acquire();
+        }
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept {
+        std::swap(node_, other.node_);
+        return *this;
+    }
+
+    ~IntrusivePtr() {
+        reset();
+    }
+
+    void reset() {
+        if (node_ && node_->count.Release()) {
+            delete node_;
+        }
+        node_ = nullptr;
+    }
+
+    T* get() const {
+        return node_ ? &node_->value : nullptr;
+    }
+
+    T* operator->() const {
+        return &node_->value;
+    }
+
+    T& operator*() const {
+        return node_->value;
+    }
+
+    explicit operator bool() const {
+        return node_ != nullptr;
+    }
+
+    uint32_t use_count() const {
+        return node_ ? node_->count.UseCount() : 0;
+    }
+};
+
+// Single allocation for both the object and its count (like std::make_shared).
+template <typename T, typename Count = AtomicCount, typename... Args>
+IntrusivePtr<T, Count> MakeIntrusive(Args&&... args) {
+    using Node = typename IntrusivePtr<T, Count>::Node;
+    return IntrusivePtr<T, Count>(new Node(std::forward<Args>(args)...));
+}
+
+template <typename MakePtr>
+size_t allocations_per_pointer(MakePtr make) {
+    SilencedOutput silenced;
+    size_t before = std_string_view_demo::allocation_count();
+    {
+        auto p = make();
+    }
+    return std_string_view_demo::allocation_count() - before;
+}
+
+// "Copy storm": each of the threads copies (and destroys the copy of) the same pointer in a tight loop.
+// Returns average time (in ns) per copy, measured across all threads.
+template <typename Ptr>
+double copy_storm_ns(const Ptr& source, unsigned threadCount, int copiesPerThread) {
+    // creating threads allocates and operator new logs it
+    SilencedOutput silenced;
+    std::atomic<int64_t> sink{0};
+    auto copy = [&] {
+        int64_t sum = 0;
+        for (int i = 0; i < copiesPerThread; ++i) {
+            Ptr copy(source);
+            sum += copy->GetValue();
+        }
+        sink += sum;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    // the calling thread is one of the threads so BiasedCount's owner takes part in the storm
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(copy);
+    }
+    copy();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    assert(sink == static_cast<int64_t>(threadCount) * copiesPerThread * source->GetValue());
+    return std::chrono::duration<double, std::nano>(end - start).count() / copiesPerThread;
+}
+
+void benchmark() {
+    std::cout << "intrusive_ptr_demo::benchmark()" << std::endl;
+
+    std::cout << "allocations per pointer: "
+        << "shared_ptr(new) = " << allocations_per_pointer([] { return std::shared_ptr<integer::Integer>(new integer::Integer(1)); })
+        << ", make_shared = " << allocations_per_pointer([] { return std::make_shared<integer::Integer>(1); })
+        << ", MakeIntrusive = " << allocations_per_pointer([] { return MakeIntrusive<integer::Integer>(1); })
+        << std::endl;
+
+    auto shared = std::make_shared<integer::Integer>(1);
+    auto atomic = MakeIntrusive<integer::Integer, AtomicCount>(1);
+    auto biased = MakeIntrusive<integer::Integer, BiasedCount>(1);
+    auto local = MakeIntrusive<integer::Integer, LocalCount>(1);
+
+    const int copies = 2000000;
+    std::cout << "ns per copy, single thread: "
+        << "shared_ptr = " << copy_storm_ns(shared, 1, copies)
+        << ", IntrusivePtr<AtomicCount> = " << copy_storm_ns(atomic, 1, copies)
+        << ", IntrusivePtr<BiasedCount> = " << copy_storm_ns(biased, 1, copies)
+        << ", IntrusivePtr<LocalCount> = " << copy_storm_ns(local, 1, copies)
+        << std::endl;
+
+    // LocalCount is not thread safe so it's not part of multi-threaded runs
+    std::vector<unsigned> threadCounts{2, 4};
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > 4) {
+        threadCounts.push_back(hardwareThreads);
+    }
+    for (unsigned threads : threadCounts) {
+        std::cout << "ns per copy, " << threads << " threads: "
+            << "shared_ptr = " << copy_storm_ns(shared, threads, copies)
+            << ", IntrusivePtr<AtomicCount> = " << copy_storm_ns(atomic, threads, copies)
+            << ", IntrusivePtr<BiasedCount> = " << copy_storm_ns(biased, threads, copies)
+            << std::endl;
+    }
+    assert(shared.use_count() == 1 && atomic.use_count() == 1 && biased.use_count() == 1);
+}
+
+}
+
+namespace epoch_reclamation_demo {
+
+//
+// Epoch based reclamation
+//
+// weak_ptr_demo_1::Printer2::print() calls expired() and lock() on each access: both are atomic operations on
+// the control block which is shared by all readers so with many reader threads the cache line holding it
+// bounces between cores. Epoch based reclamation lets readers access the shared resource without writing
+// anything shared:
+//  - each reader thread has its own slot; when it starts reading it publishes the current global epoch in
+//    it ("pins" the epoch) and clears it when done
+//  - writer replaces the resource and retires the old one, tagged with the epoch at the time of retirement,
+//    then advances the global epoch
+//  - retired object is deleted once every pinned reader has pinned a later epoch: such readers started after
+//    the replacement so they can't hold a pointer to the retired object
+//
+
+class EpochDomain {
+public:
+    static constexpr size_t maxThreads = 64;
+
+private:
+    static constexpr uint64_t idle = UINT64_MAX;
+
+    // each slot in its own cache line so readers don't share them
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{idle};
+        std::atomic<bool> used{false};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        void* p;
+        void (*deleter)(void*);
+    };
+
+    Slot slots_[maxThreads];
+    std::atomic<uint64_t> epoch_{0};
+    std::mutex retiredMutex_;
+    std::vector<Retired> retired_;
+
+    // deletes retired objects which no pinned reader can access; retiredMutex_ must be locked
+    void Reclaim() {
+        uint64_t oldestPinned = idle;
+        for (auto& slot : slots_) {
+            oldestPinned = std::min(oldestPinned, slot.epoch.load());
+        }
+        auto end = std::partition(retired_.begin(), retired_.end(), [oldestPinned](const Retired& retired) {
+            return retired.epoch >= oldestPinned;
+        });
+        for (auto it = end; it != retired_.end(); ++it) {
+            it->deleter(it->p);
+        }
+        retired_.erase(end, retired_.end());
+    }
+
+public:
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // must not be destroyed while any thread is reading
+    ~EpochDomain() {
+        for (auto& retired : retired_) {
+            retired.deleter(retired.p);
+        }
+    }
+
+    // Registration of the reading thread: owns one of the slots. It should be created once per thread and
+    // reused for all reads, not created per read.
+    class Reader {
+        friend class EpochDomain;
+        Slot* slot_;
+    public:
+        explicit Reader(EpochDomain& domain) : slot_(nullptr) {
+            for (auto& slot : domain.slots_) {
+                bool expected = false;
+                if (slot.used.compare_exchange_strong(expected, true)) {
+                    slot_ = &slot;
+                    return;
+                }
+            }
+            throw std::length_error("EpochDomain: all reader slots are in use");
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        ~Reader() {
+            slot_->used = false;
+        }
+    };
+
+    // Pins the current epoch for the lifetime of the guard; pointers loaded through EpochProtected::Load()
+    // can be used while the guard exists.
+    class Guard {
+        Slot* slot_;
+    public:
+        Guard(EpochDomain& domain, Reader& reader) : slot_(reader.slot_) {
+            // seq_cst: the pinned epoch must be visible to the writer before the resource pointer is read
+            slot_->epoch.store(domain.epoch_.load());
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() {
+            slot_->epoch.store(idle, std::memory_order_release);
+        }
+    };
+
+    template <typename T>
+    void Retire(T* p) {
+        if (p == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(retiredMutex_);
+        retired_.push_back({epoch_.fetch_add(1), p, [](void* p) { delete static_cast<T*>(p); }});
+        Reclaim();
+    }
+};
+
+// Resource which is read by many threads and replaced (or released) by a writer; the replaced one is
+// retired to the EpochDomain.
+template <typename T>
+class EpochProtected {
+    EpochDomain& domain_;
+    std::atomic<T*> current_;
+public:
+    EpochProtected(EpochDomain& domain, T* p) : domain_(domain), current_(p) {}
+    EpochProtected(const EpochProtected&) = delete;
+    EpochProtected& operator=(const EpochProtected&) = delete;
+
+    ~EpochProtected() {
+        domain_.Retire(current_.load());
+    }
+
+    // nullptr if the resource was released; the pointer is valid while the guard exists
+    T* Load(const EpochDomain::Guard&) const {
+        return current_.load();
+    }
+
+    void Replace(T* p) {
+        domain_.Retire(current_.exchange(p));
+    }
+
+    void Release() {
+        Replace(nullptr);
+    }
+};
+
+// Same role as weak_ptr_demo_1::Printer2: it doesn't own the int and can check whether it was released;
+// reading it doesn't change any counts.
+class Printer3 {
+    const EpochProtected<int>* pInt_{nullptr};
+public:
+    void set_value(const EpochProtected<int>& pInt) {
+        pInt_ = &pInt;
+    }
+
+    void print(EpochDomain& domain, EpochDomain::Reader& reader) const {
+        EpochDomain::Guard guard(domain, reader);
+        if (const int* p = pInt_->Load(guard)) {
+            std::cout << "Printer3::print(): value = " << *p << std::endl;
+        } else {
+            std::cout << "Printer3::print(): resource has been released." << std::endl;
+        }
+    }
+};
+
+void solution() {
+    std::cout << "epoch_reclamation_demo::solution()" << std::endl;
+
+    EpochDomain domain;
+    EpochDomain::Reader reader(domain);
+    EpochProtected<int> pInt(domain, new int{12});
+
+    Printer3 printer;
+    printer.set_value(pInt);
+    printer.print(domain, reader);
+    // output: Printer3::print(): value = 12
+
+    pInt.Release();
+    printer.print(domain, reader);
+    // output: Printer3::print(): resource has been released.
+}
+
+// Each reader thread reads the resource readsPerThread times while a writer thread calls write() every 100us;
+// returns the number of reads per second across all reader threads.
+template <typename ReadOnce, typename Write>
+double reads_per_second(unsigned readerCount, int readsPerThread, ReadOnce readOnce, Write write) {
+    std::atomic<int64_t> sink{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int n = 1; !done; ++n) {
+            write(n % 100 + 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < readerCount; ++t) {
+        readers.emplace_back([&] {
+            auto read = readOnce();
+            while (!start) {
+                std::this_thread::yield();
+            }
+            int64_t sum = 0;
+            for (int i = 0; i < readsPerThread; ++i) {
+                sum += read();
+            }
+            sink += sum;
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    done = true;
+    writer.join();
+    assert(sink > 0);
+    return readerCount * static_cast<double>(readsPerThread) / std::chrono::duration<double>(end - begin).count();
+}
+
+void benchmark() {
+    std::cout << "epoch_reclamation_demo::benchmark()" << std::endl;
+
+    const unsigned readers = 32;
+    const int reads = 1000000;
+
+    double weakReads;
+    double epochReads;
+    {
+        // writers allocate (and operator new logs) while the readers run
+        SilencedOutput silenced;
+
+        // weak_ptr: each read is expired() + lock() (and destruction of the locked shared_ptr); the writer
+        // replaces the owning shared_ptr and a reader which finds its weak_ptr expired takes the new one
+        auto resource = std::make_shared<int>(1);
+        weakReads = reads_per_second(readers, reads, [&] {
+            return [&, pInt = std::weak_ptr<int>(std::atomic_load(&resource))]() mutable {
+                if (pInt.expired()) {
+                    pInt = std::atomic_load(&resource);
+                }
+                auto p = pInt.lock();
+                return p ? *p : 0;
+            };
+        }, [&](int n) {
+            std::atomic_store(&resource, std::make_shared<int>(n));
+        });
+
+        // epoch: each read pins the epoch in the thread's own slot; the writer replaces the resource and the old
+        // one is deleted once no reader can see it
+        EpochDomain domain;
+        EpochProtected<int> pInt(domain, new int{1});
+        epochReads = reads_per_second(readers, reads, [&] {
+            return [&, reader = std::make_shared<EpochDomain::Reader>(domain)] {
+                EpochDomain::Guard guard(domain, *reader);
+                const int* p = pInt.Load(guard);
+                return p ? *p : 0;
+            };
+        }, [&](int n) {
+            pInt.Replace(new int{n});
+        });
+    }
+
+    std::cout << readers << " reader threads and a writer, reads per second: weak_ptr expired() + lock() = "
+        << weakReads << ", epoch = " << epochReads << std::endl;
+}
+
+}
+
+namespace graph_arena_demo {
+
+//
+// Region-owned graph
+//
+// weak_ptr_demo_2 breaks Project <-> Employee reference cycle by making one side weak_ptr. With large cyclic
+// graphs that means a control block per node, atomic count updates on each copy and lock() on each access
+// through a weak edge.
+// Here all nodes are owned by the graph (region) and reference each other by 32-bit handles (indices into the
+// region's storage). Cycles don't matter for the lifetime as nodes are never freed individually; nodes are
+// trivially destructible so freeing the whole region is just releasing its storage, regardless of the number
+// of nodes. Nodes are stored contiguously which makes traversal cache friendly.
+//
+
+template <typename Node>
+struct Handle {
+    static constexpr uint32_t none = UINT32_MAX;
+    uint32_t index{none};
+
+    explicit operator bool() const {
+        return index != none;
+    }
+};
+
+struct ProjectNode;
+struct EmployeeNode;
+
+struct ProjectNode {
+    int budget;
+    // employees working on the project form a singly linked list through EmployeeNode::nextInProject
+    Handle<EmployeeNode> firstEmployee;
+};
+
+struct EmployeeNode {
+    int salary;
+    Handle<ProjectNode> project;
+    Handle<EmployeeNode> nextInProject;
+};
+
+class ProjectGraph {
+    static_assert(std::is_trivially_destructible_v<ProjectNode> && std::is_trivially_destructible_v<EmployeeNode>,
+        "nodes are released together with the region, without calling their destructors");
+
+    std::vector<ProjectNode> projects_;
+    std::vector<EmployeeNode> employees_;
+
+public:
+    using ProjectId = Handle<ProjectNode>;
+    using EmployeeId = Handle<EmployeeNode>;
+
+    void Reserve(size_t projects, size_t employees) {
+        projects_.reserve(projects);
+        employees_.reserve(employees);
+    }
+
+    ProjectId AddProject(int budget) {
+        projects_.push_back({budget, {}});
+        return ProjectId{static_cast<uint32_t>(projects_.size() - 1)};
+    }
+
+    EmployeeId AddEmployee(int salary) {
+        employees_.push_back({salary, {}, {}});
+        return EmployeeId{static_cast<uint32_t>(employees_.size() - 1)};
+    }
+
+    // creates the cycle: employee -> project -> employee
+    void Assign(EmployeeId employee, ProjectId project) {
+        auto& node = (*this)[employee];
+        assert(!node.project && "employee already works on a project");
+        node.project = project;
+        node.nextInProject = (*this)[project].firstEmployee;
+        (*this)[project].firstEmployee = employee;
+    }
+
+    ProjectNode& operator[](ProjectId project) {
+        assert(project.index < projects_.size());
+        return projects_[project.index];
+    }
+
+    EmployeeNode& operator[](EmployeeId employee) {
+        assert(employee.index < employees_.size());
+        return employees_[employee.index];
+    }
+
+    template <typename Visit>
+    void ForEachEmployee(ProjectId project, Visit visit) {
+        for (auto employee = (*this)[project].firstEmployee; employee; employee = (*this)[employee].nextInProject) {
+            visit((*this)[employee]);
+        }
+    }
+
+    size_t ProjectCount() const {
+        return projects_.size();
+    }
+
+    size_t EmployeeCount() const {
+        return employees_.size();
+    }
+
+    // Frees all nodes at once: no destructors are run and no cycles need to be broken.
+    void Clear() {
+        std::vector<ProjectNode>().swap(projects_);
+        std::vector<EmployeeNode>().swap(employees_);
+    }
+};
+
+void demo() {
+    std::cout << "graph_arena_demo::demo()" << std::endl;
+    ProjectGraph graph;
+    auto project = graph.AddProject(1000);
+    auto employee1 = graph.AddEmployee(10);
+    auto employee2 = graph.AddEmployee(20);
+    graph.Assign(employee1, project);
+    graph.Assign(employee2, project);
+
+    int salaries = 0;
+    graph.ForEachEmployee(project, [&](const EmployeeNode& employee) {
+        salaries += employee.salary;
+    });
+    assert(salaries == 30);
+    assert(graph[graph[employee1].project].budget == 1000);
+    std::cout << "Project budget = " << graph[project].budget << ", salaries = " << salaries << std::endl;
+    // graph goes out of scope: both nodes are released although they reference each other
+}
+
+// The same graph built from shared_ptr/weak_ptr as in weak_ptr_demo_2::show_solution()
+struct SharedEmployee;
+
+struct SharedProject {
+    int budget;
+    std::vector<std::weak_ptr<SharedEmployee>> employees;
+};
+
+struct SharedEmployee {
+    int salary;
+    std::shared_ptr<SharedProject> project;
+};
+
+template <typename Function>
+double time_ms(Function function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmark() {
+    std::cout << "graph_arena_demo::benchmark()" << std::endl;
+
+    const int projectCount = 100000;
+    const int employeesPerProject = 10;
+    int64_t sharedSum = 0;
+    int64_t graphSum = 0;
+    double sharedMs[3];
+    double graphMs[3];
+
+    {
+        SilencedOutput silenced;
+        std::vector<std::shared_ptr<SharedProject>> projects;
+        std::vector<std::shared_ptr<SharedEmployee>> employees;
+        sharedMs[0] = time_ms([&] {
+            projects.reserve(projectCount);
+            employees.reserve(projectCount * employeesPerProject);
+            for (int p = 0; p < projectCount; ++p) {
+                projects.push_back(std::make_shared<SharedProject>(SharedProject{p, {}}));
+                for (int e = 0; e < employeesPerProject; ++e) {
+                    employees.push_back(std::make_shared<SharedEmployee>(SharedEmployee{e, projects.back()}));
+                    projects.back()->employees.push_back(employees.back());
+                }
+            }
+        });
+        sharedMs[1] = time_ms([&] {
+            for (auto& project : projects) {
+                for (auto& weakEmployee : project->employees) {
+                    if (auto employee = weakEmployee.lock()) {
+                        sharedSum += employee->salary + employee->project->budget;
+                    }
+                }
+            }
+        });
+        sharedMs[2] = time_ms([&] {
+            employees.clear();
+            projects.clear();
+        });
+    }
+
+    {
+        SilencedOutput silenced;
+        ProjectGraph graph;
+        std::vector<ProjectGraph::ProjectId> projects;
+        graphMs[0] = time_ms([&] {
+            graph.Reserve(projectCount, projectCount * employeesPerProject);
+            projects.reserve(projectCount);
+            for (int p = 0; p < projectCount; ++p) {
+                projects.push_back(graph.AddProject(p));
+                for (int e = 0; e < employeesPerProject; ++e) {
+                    graph.Assign(graph.AddEmployee(e), projects.back());
+                }
+            }
+        });
+        graphMs[1] = time_ms([&] {
+            for (auto project : projects) {
+                graph.ForEachEmployee(project, [&](const EmployeeNode& employee) {
+                    graphSum += employee.salary + graph[employee.project].budget;
+                });
+            }
+        });
+        graphMs[2] = time_ms([&] {
+            graph.Clear();
+        });
+    }
+    assert(sharedSum == graphSum);
+
+    std::cout << projectCount << " projects, " << employeesPerProject << " employees each (build / traverse / free, ms):"
+        << std::endl << "shared_ptr + weak_ptr: " << sharedMs[0] << " / " << sharedMs[1] << " / " << sharedMs[2]
+        << std::endl << "ProjectGraph: " << graphMs[0] << " / " << graphMs[1] << " / " << graphMs[2]
+        << std::endl;
+}
+
+}
+
+namespace slot_map_demo {
+
+//
+// Generational slot map
+//
+// weak_ptr_demo_1::show_the_problem(): Printer holds int* which dangles after the int is deleted and
+// there's no way to check it. weak_ptr can check it but pays with a control block per object and atomic
+// count updates on each lock().
+// SlotMap stores values contiguously and hands out keys: (slot index, generation). Slot maps key to the
+// value's position; erasing a value bumps the slot's generation so all keys issued for it become stale.
+// Insert, erase and lookup are O(1); stale key is detected by comparing generations.
+// Generation is odd while the slot holds a value and even while it's free so a key can never match a free slot.
+//
+
+template <typename T>
+class SlotMap {
+public:
+    struct Key {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+private:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    struct Slot {
+        // position of the value in values_ when occupied; next free slot otherwise
+        uint32_t valueOrNextFree;
+        // incremented on each insert and erase: odd when occupied
+        // (after 2^31 reuses of the same slot an old key could become valid again)
+        uint32_t generation;
+    };
+
+    std::vector<T> values_;
+    // values_[i] is referenced by slots_[slotOf_[i]]; needed for moving the last value into the erased position
+    std::vector<uint32_t> slotOf_;
+    std::vector<Slot> slots_;
+    uint32_t freeHead_{none};
+
+    const Slot* FindSlot(Key key) const {
+        if (key.index >= slots_.size()) {
+            return nullptr;
+        }
+        const Slot& slot = slots_[key.index];
+        return slot.generation == key.generation && (slot.generation & 1) ? &slot : nullptr;
+    }
+
+    // makes room for one more element (growing geometrically, like push_back) so the next push_back can't throw
+    template <typename V>
+    static void ReserveOneMore(V& v) {
+        if (v.size() == v.capacity()) {
+            v.reserve(std::max<size_t>(16, 2 * v.capacity()));
+        }
+    }
+
+public:
+    template <typename... Args>
+    Key Emplace(Args&&... args) {
+        // Everything which can throw (allocations, T's constructor) happens before the map is changed: if it
+        // throws, the map stays as it was.
+        ReserveOneMore(slotOf_);
+        if (freeHead_ == none) {
+            ReserveOneMore(slots_);
+        }
+        values_.emplace_back(std::forward<Args>(args)...);
+
+        uint32_t index;
+        if (freeHead_ != none) {
+            index = freeHead_;
+            freeHead_ = slots_[index].valueOrNextFree;
+        } else {
+            index = static_cast<uint32_t>(slots_.size());
+            slots_.push_back({0, 0});
+        }
+        Slot& slot = slots_[index];
+        slot.valueOrNextFree = static_cast<uint32_t>(values_.size() - 1);
+        ++slot.generation;
+        slotOf_.push_back(index);
+        return {index, slot.generation};
+    }
+
+    Key Insert(T value) {
+        return Emplace(std::move(value));
+    }
+
+    // returns false if the key is stale
+    bool Erase(Key key) {
+        if (!FindSlot(key)) {
+            return false;
+        }
+        Slot& slot = slots_[key.index];
+        uint32_t position = slot.valueOrNextFree;
+        // keep values contiguous: move the last value into the erased position
+        if (position != values_.size() - 1) {
+            values_[position] = std::move(values_.back());
+            slotOf_[position] = slotOf_.back();
+            slots_[slotOf_[position]].valueOrNextFree = position;
+        }
+        values_.pop_back();
+        slotOf_.pop_back();
+        ++slot.generation;
+        slot.valueOrNextFree = freeHead_;
+        freeHead_ = key.index;
+        return true;
+    }
+
+    // nullptr if the key is stale
+    T* Find(Key key) {
+        const Slot* slot = FindSlot(key);
+        return slot ? &values_[slot->valueOrNextFree] : nullptr;
+    }
+
+    const T* Find(Key key) const {
+        const Slot* slot = FindSlot(key);
+        return slot ? &values_[slot->valueOrNextFree] : nullptr;
+    }
+
+    bool Contains(Key key) const {
+        return FindSlot(key) != nullptr;
+    }
+
+    size_t Size() const {
+        return values_.size();
+    }
+
+    // values are iterated contiguously, in no particular order
+    auto begin() { return values_.begin(); }
+    auto end() { return values_.end(); }
+    auto begin() const { return values_.begin(); }
+    auto end() const { return values_.end(); }
+};
+
+// Printer from weak_ptr_demo_1::show_the_problem() which holds a key instead of int* and so can detect that
+// the int was erased.
+class Printer4 {
+    const SlotMap<int>* ints_{nullptr};
+    SlotMap<int>::Key key_{};
+public:
+    void set_value(const SlotMap<int>& ints, SlotMap<int>::Key key) {
+        ints_ = &ints;
+        key_ = key;
+    }
+
+    void print() const {
+        if (const int* p = ints_->Find(key_)) {
+            std::cout << "Printer4::print(): value = " << *p << std::endl;
+        } else {
+            std::cout << "Printer4::print(): value has been erased." << std::endl;
+        }
+    }
+};
+
+void demo() {
+    std::cout << "slot_map_demo::demo()" << std::endl;
+
+    SlotMap<int> ints;
+    Printer4 printer;
+    auto key = ints.Insert(12);
+    printer.set_value(ints, key);
+    printer.print();
+    // output: Printer4::print(): value = 12
+
+    ints.Erase(key);
+    // the slot gets reused but with the next generation
+    auto key2 = ints.Insert(13);
+    assert(key2.index == key.index && !ints.Contains(key));
+    printer.print();
+    // output: Printer4::print(): value has been erased.
+}
+
+void benchmark() {
+    std::cout << "slot_map_demo::benchmark()" << std::endl;
+
+    const int count = 1000000;
+    const int rounds = 10;
+    int64_t weakSum = 0;
+    int64_t slotMapSum = 0;
+    double weakMs;
+    double slotMapMs;
+
+    // every other value is erased, then all (valid and stale) references are looked up `rounds` times
+    {
+        SilencedOutput silenced;
+        std::vector<std::shared_ptr<int>> owners;
+        std::vector<std::weak_ptr<int>> references;
+        for (int i = 0; i < count; ++i) {
+            owners.push_back(std::make_shared<int>(i));
+            references.push_back(owners.back());
+        }
+        for (int i = 0; i < count; i += 2) {
+            owners[i].reset();
+        }
+        weakMs = graph_arena_demo::time_ms([&] {
+            for (int round = 0; round < rounds; ++round) {
+                for (auto& reference : references) {
+                    if (auto p = reference.lock()) {
+                        weakSum += *p;
+                    }
+                }
+            }
+        });
+    }
+
+    {
+        SilencedOutput silenced;
+        SlotMap<int> ints;
+        std::vector<SlotMap<int>::Key> keys;
+        for (int i = 0; i < count; ++i) {
+            keys.push_back(ints.Insert(i));
+        }
+        for (int i = 0; i < count; i += 2) {
+            ints.Erase(keys[i]);
+        }
+        slotMapMs = graph_arena_demo::time_ms([&] {
+            for (int round = 0; round < rounds; ++round) {
+                for (auto key : keys) {
+                    if (const int* p = ints.Find(key)) {
+                        slotMapSum += *p;
+                    }
+                }
+            }
+        });
+    }
+    assert(weakSum == slotMapSum);
+
+    std::cout << rounds << " x " << count << " lookups (half stale), ms: weak_ptr::lock() = " << weakMs
+        << ", SlotMap::Find() = " << slotMapMs << std::endl;
+}
+
+}
+
+namespace arena_ptr_demo {
+
+//
+// unique_ptr with arena deleter
+//
+// unique_ptr_demo uses unique_ptr<Integer> with the default deleter: each object is a separate new/delete.
+// ArenaPtr<T, Arena> is unique_ptr whose deleter destroys the object and returns its memory to the arena
+// it was allocated from:
+//  - MonotonicArena: bump allocation from large blocks; returning memory is a no-op, all of it is reclaimed
+//    at once by DestroyAll()
+//  - PoolArena<T>: fixed size slots with a free list; returned slot is reused by the next allocation
+// Objects created by MonotonicArena::New() don't need to be destroyed one by one at all: DestroyAll() runs
+// destructors only for types which are not trivially destructible and then releases memory in O(blocks).
+//
+
+class MonotonicArena {
+    struct Destructor {
+        void* p;
+        void (*destroy)(void*);
+    };
+
+    const size_t blockSize_;
+    std::vector<std::unique_ptr<std::max_align_t[]>> blocks_;
+    unsigned char* current_{nullptr};
+    unsigned char* end_{nullptr};
+    size_t firstBlockBytes_{0};
+    // objects created by New() which must be destroyed by DestroyAll()
+    std::vector<Destructor> destructors_;
+
+    void AddBlock(size_t minSize) {
+        size_t size = std::max(blockSize_, minSize);
+        size_t count = (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        blocks_.emplace_back(new std::max_align_t[count]);
+        current_ = reinterpret_cast<unsigned char*>(blocks_.back().get());
+        end_ = current_ + count * sizeof(std::max_align_t);
+        if (blocks_.size() == 1) {
+            firstBlockBytes_ = count * sizeof(std::max_align_t);
+        }
+    }
+
+public:
+    explicit MonotonicArena(size_t blockSize = 64 * 1024) : blockSize_(blockSize) {}
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        DestroyAll();
+    }
+
+    // alignment must be a power of 2, not greater than alignof(std::max_align_t)
+    void* Allocate(size_t size, size_t alignment) {
+        assert(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+        auto aligned = [&] {
+            return reinterpret_cast<unsigned char*>(
+                (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(uintptr_t(alignment) - 1));
+        };
+        if (current_ == nullptr || aligned() + size > end_) {
+            AddBlock(size);
+        }
+        unsigned char* p = aligned();
+        current_ = p + size;
+        return p;
+    }
+
+    // memory is reclaimed by DestroyAll()
+    void Deallocate(void*, size_t) {}
+
+    // Object is destroyed by DestroyAll().
+    template <typename T, typename... Args>
+    T* New(Args&&... args) {
+        T* p = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            destructors_.push_back({p, [](void* p) { static_cast<T*>(p)->~T(); }});
+        }
+        return p;
+    }
+
+    // Destroys objects created by New() and releases all memory; the first block is kept for reuse.
+    // ArenaPtrs to this arena must not outlive this call.
+    void DestroyAll() {
+        for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+            it->destroy(it->p);
+        }
+        destructors_.clear();
+        if (blocks_.size() > 1) {
+            blocks_.erase(blocks_.begin() + 1, blocks_.end());
+        }
+        if (!blocks_.empty()) {
+            current_ = reinterpret_cast<unsigned char*>(blocks_.front().get());
+            end_ = current_ + firstBlockBytes_;
+        }
+    }
+};
+
+template <typename T, size_t slabSize = 4096>
+class PoolArena {
+    slab_pool::SlabPool<T, slabSize> slots_;
+
+public:
+    void* Allocate(size_t size, size_t alignment) {
+        assert(size <= sizeof(T) && alignment <= alignof(T));
+        return slots_.Allocate();
+    }
+
+    void Deallocate(void* p, size_t) {
+        slots_.Deallocate(p);
+    }
+};
+
+template <typename T, typename Arena>
+struct ArenaDeleter {
+    Arena* arena;
+
+    void operator()(T* p) const {
+        p->~T();
+        arena->Deallocate(p, sizeof(T));
+    }
+};
+
+template <typename T, typename Arena = MonotonicArena>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T, Arena>>;
+
+template <typename T, typename Arena, typename... Args>
+ArenaPtr<T, Arena> MakeArenaPtr(Arena& arena, Args&&... args) {
+    void* memory = arena.Allocate(sizeof(T), alignof(T));
+    try {
+        return ArenaPtr<T, Arena>(new (memory) T(std::forward<Args>(args)...), ArenaDeleter<T, Arena>{&arena});
+    } catch (...) {
+        arena.Deallocate(memory, sizeof(T));
+        throw;
+    }
+}
+
+void demo() {
+    std::cout << "arena_ptr_demo::demo()" << std::endl;
+
+    PoolArena<integer::Integer> pool;
+    {
+        // ownership semantics are those of unique_ptr
+        ArenaPtr<integer::Integer, PoolArena<integer::Integer>> p = MakeArenaPtr<integer::Integer>(pool, 1);
+        auto p2 = std::move(p);
+        assert(!p && p2->GetValue() == 1);
+        // p2 is destroyed and its slot returned to the pool
+    }
+
+    MonotonicArena arena;
+    auto s = MakeArenaPtr<std::string>(arena, "not trivially destructible");
+    std::cout << *s << std::endl;
+    s.reset();
+    // no destructors to run: memory is simply released
+    for (int i = 0; i < 1000; ++i) {
+        arena.New<integer::Integer>(i);
+    }
+    arena.DestroyAll();
+}
+
+// create/destroy cycles in batches: batchSize objects are created, then all of them are destroyed
+template <typename Create, typename DestroyBatch>
+double cycles_ms(int cycles, int batchSize, Create create, DestroyBatch destroyBatch) {
+    SilencedOutput silenced;
+    return graph_arena_demo::time_ms([&] {
+        for (int done = 0; done < cycles; done += batchSize) {
+            for (int i = 0; i < batchSize; ++i) {
+                create(i);
+            }
+            destroyBatch();
+        }
+    });
+}
+
+void benchmark() {
+    std::cout << "arena_ptr_demo::benchmark()" << std::endl;
+
+    using integer::Integer;
+    const int cycles = 10000000;
+    const int batchSize = 1000;
+    int64_t sum = 0;
+
+    std::vector<std::unique_ptr<Integer>> uniquePtrs;
+    uniquePtrs.reserve(batchSize);
+    double uniquePtrMs = cycles_ms(cycles, batchSize, [&](int i) {
+        uniquePtrs.push_back(std::make_unique<Integer>(i));
+    }, [&] {
+        sum += uniquePtrs.back()->GetValue();
+        uniquePtrs.clear();
+    });
+
+    PoolArena<Integer> pool;
+    std::vector<ArenaPtr<Integer, PoolArena<Integer>>> poolPtrs;
+    poolPtrs.reserve(batchSize);
+    double poolMs = cycles_ms(cycles, batchSize, [&](int i) {
+        poolPtrs.push_back(MakeArenaPtr<Integer>(pool, i));
+    }, [&] {
+        sum += poolPtrs.back()->GetValue();
+        poolPtrs.clear();
+    });
+
+    MonotonicArena arena;
+    std::vector<ArenaPtr<Integer>> arenaPtrs;
+    arenaPtrs.reserve(batchSize);
+    double arenaMs = cycles_ms(cycles, batchSize, [&](int i) {
+        arenaPtrs.push_back(MakeArenaPtr<Integer>(arena, i));
+    }, [&] {
+        sum += arenaPtrs.back()->GetValue();
+        arenaPtrs.clear();
+        arena.DestroyAll();
+    });
+
+    // no per-object destruction at all
+    std::vector<Integer*> raw;
+    raw.reserve(batchSize);
+    double bulkMs = cycles_ms(cycles, batchSize, [&](int i) {
+        raw.push_back(arena.New<Integer>(i));
+    }, [&] {
+        sum += raw.back()->GetValue();
+        raw.clear();
+        arena.DestroyAll();
+    });
+
+    assert(sum == 4 * static_cast<int64_t>(cycles / batchSize) * (batchSize - 1));
+    std::cout << cycles << " create/destroy cycles, ms: unique_ptr = " << uniquePtrMs
+        << ", ArenaPtr<PoolArena> = " << poolMs
+        << ", ArenaPtr<MonotonicArena> = " << arenaMs
+        << ", MonotonicArena::New + DestroyAll = " << bulkMs << std::endl;
+}
+
+}
+
 // RAII (Resource Acquisition Is Initialization)
 // The lifetime of the resource is bound to the local object so when object
 // goes out of scope, its destructor will automatically release the resource.
@@ -785,6 +2207,16 @@ void run() {
     shared_ptr_demo::demo();
     weak_ptr_demo_1::demo();
     weak_ptr_demo_2::demo();
+    // integer_allocation_demo();
+    // intrusive_ptr_demo::benchmark();
+    // epoch_reclamation_demo::solution();
+    // epoch_reclamation_demo::benchmark();
+    // graph_arena_demo::demo();
+    // graph_arena_demo::benchmark();
+    // slot_map_demo::demo();
+    // slot_map_demo::benchmark();
+    // arena_ptr_demo::demo();
+    // arena_ptr_demo::benchmark();
 }
 
 }
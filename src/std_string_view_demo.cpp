@@ -1,15 +1,32 @@
 #include <std_string_view_demo.hpp>
+#include <atomic>
 #include <iostream>
 
+namespace {
+std::atomic<size_t> allocationCount{0};
+std::atomic<bool> logAllocations{true};
+}
 
 // override operator new (must be in global namespace) so we can log any memory allocations
+// (this replaces it for the whole program; allocation_count() exposes the number of calls)
 void* operator new(std::size_t count){
-    std::cout << "   " << count << " bytes" << std::endl;
+    ++allocationCount;
+    if (logAllocations.load(std::memory_order_relaxed)) {
+        std::cout << "   " << count << " bytes" << std::endl;
+    }
     return malloc(count);
 }
 
 namespace std_string_view_demo {
 
+size_t allocation_count() {
+    return allocationCount;
+}
+
+bool log_allocations(bool enable) {
+    return logAllocations.exchange(enable);
+}
+
 // error: ‘void* std_string_view_demo::operator new(std::size_t)’ may not be declared within a namespace
 // (see https://stackoverflow.com/questions/6210921/operator-new-inside-namespace)
 // void* operator new(std::size_t count){}
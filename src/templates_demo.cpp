@@ -1,10 +1,231 @@
 #include <templates_demo.hpp>
+#include <slab_pool.hpp>
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace templates_demo {
 
+// Parallel execution
+//
+// SIMD makes a single core faster but for arrays with hundreds of millions of elements we want to use all cores.
+// Array is split into one contiguous chunk per worker thread, each worker reduces its own chunk and partial results
+// are combined in a tree (pairwise, in log2(threads) steps). Combining in a fixed tree order also makes the result
+// deterministic for a given number of threads (important for floating point sums).
+//
+// NUMA: memory pages are placed on the NUMA node of the thread which first writes to them (Linux "first touch" policy).
+// Chunk i is always processed by worker i and on Linux worker i is pinned to the i-th CPU the process may run on, so
+// if the array is initialized with parallel_fill() on the same pool, every worker later reads memory local to its
+// node (the scheduler can't move the worker to a CPU on another node).
+namespace execution {
+
+// Fixed set of worker threads which are created once and reused for every parallel operation.
+// run_on_each() must not be called concurrently from several threads.
+class ThreadPool {
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    std::function<void(size_t)> task_;
+    std::exception_ptr exception_;
+    size_t generation_{0};
+    size_t pending_{0};
+    bool stop_{false};
+
+    // Pins worker to the index-th CPU (modulo count) from the process affinity mask. Consecutive CPU numbers are
+    // usually on the same node so neighbouring chunks stay on the same node. Best effort: on failure the worker
+    // just stays unpinned.
+    static void pin(std::thread& worker, size_t index) {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+            return;
+        }
+        size_t nth = index % CPU_COUNT(&allowed);
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed) && nth-- == 0) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set);
+                return;
+            }
+        }
+#else
+        (void)worker;
+        (void)index;
+#endif
+    }
+
+    void worker_loop(size_t index) {
+        size_t seenGeneration = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                startCv_.wait(lock, [&] { return stop_ || generation_ != seenGeneration; });
+                if (stop_) {
+                    return;
+                }
+                seenGeneration = generation_;
+            }
+
+            std::exception_ptr exception;
+            try {
+                task_(index);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (exception && !exception_) {
+                exception_ = exception;
+            }
+            if (--pending_ == 0) {
+                doneCv_.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+            pin(workers_.back(), i);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        startCv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {
+        return workers_.size();
+    }
+
+    // Calls task(i) on worker i for every worker and blocks until all of them finish.
+    // If any task throws, the first exception is rethrown here.
+    void run_on_each(std::function<void(size_t)> task) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_ = std::move(task);
+        exception_ = nullptr;
+        pending_ = workers_.size();
+        ++generation_;
+        startCv_.notify_all();
+        doneCv_.wait(lock, [&] { return pending_ == 0; });
+        task_ = nullptr;
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+
+// Execution policy tag. Overloads of array algorithms which accept it run on the given thread pool.
+struct ParallelPolicy {
+    ThreadPool& pool;
+};
+
+// [begin, end) of chunk i when size elements are split into chunks parts
+inline std::pair<size_t, size_t> chunk_range(size_t size, size_t chunks, size_t i) {
+    return {size * i / chunks, size * (i + 1) / chunks};
+}
+
+// Reduces arr[0..size) with leaf(const T*, size_t) -> R applied on each chunk and associative op(R, R) -> R
+// used to combine partial results. op does not need to be commutative: partial results are combined in chunk order.
+template <typename T, typename Leaf, typename Op>
+auto reduce(const ParallelPolicy& policy, const T* arr, size_t size, Leaf leaf, Op op) {
+    using R = decltype(leaf(arr, size));
+
+    // Each chunk has at least one element so leaf never has to deal with empty input (e.g. min/max).
+    size_t chunks = std::min(policy.pool.size(), size);
+    if (chunks <= 1) {
+        return leaf(arr, size);
+    }
+
+    std::vector<R> partial(chunks);
+    policy.pool.run_on_each([&](size_t worker) {
+        if (worker < chunks) {
+            auto range = chunk_range(size, chunks, worker);
+            partial[worker] = leaf(arr + range.first, range.second - range.first);
+        }
+    });
+
+    // Tree combine: (0,1) (2,3) ... then (0,2) (4,6) ... until everything is in partial[0]
+    for (size_t stride = 1; stride < chunks; stride *= 2) {
+        for (size_t i = 0; i + stride < chunks; i += 2 * stride) {
+            partial[i] = op(partial[i], partial[i + stride]);
+        }
+    }
+    return partial[0];
+}
+
+// Reduction with a user-supplied associative operator only. identity must be the neutral element of op
+// (0 for +, 1 for *, ...) as it is used as the starting value of every chunk.
+template <typename T, typename Op>
+T reduce(const ParallelPolicy& policy, const T* arr, size_t size, T identity, Op op) {
+    return reduce(policy, arr, size,
+        [&](const T* chunk, size_t n) {
+            T acc = identity;
+            for (size_t i = 0; i < n; ++i) {
+                acc = op(acc, chunk[i]);
+            }
+            return acc;
+        },
+        op);
+}
+
+// Initializes array with the same chunk-to-worker assignment used by reduce() (see NUMA note above).
+template <typename T>
+void parallel_fill(const ParallelPolicy& policy, T* arr, size_t size, const T& value) {
+    size_t chunks = policy.pool.size();
+    policy.pool.run_on_each([&](size_t worker) {
+        auto range = chunk_range(size, chunks, worker);
+        std::fill(arr + range.first, arr + range.second, value);
+    });
+}
+
+} // namespace execution
+
 namespace introduction{
 
 int max(int n1, int n2) {
@@ -39,8 +260,199 @@ T add(const T& t1, const T& t2) {
     return t1 + t2;
 }
 
+// Vectorized reductions
+//
+// Generic reduction loops have a loop-carried dependency: each addition (or comparison) has to wait for the result
+// of the previous one. Keeping several independent accumulators breaks that chain so CPU can execute them in parallel
+// and compiler can keep them in SIMD registers.
+// For int, float and double we also provide hand written AVX2 versions. CPU might not support AVX2 so the
+// implementation is selected at runtime. All other types use the generic (scalar) loop.
+namespace simd {
+
+template <typename T>
+struct is_vectorizable {
+    static constexpr bool value =
+        std::is_same<T, int>::value || std::is_same<T, float>::value || std::is_same<T, double>::value;
+};
+
+// Number of independent accumulators used by the portable version.
+constexpr size_t accumulators = 4;
+
+template <typename T>
+T sum_unrolled(const T* arr, size_t size) {
+    T acc[accumulators]{};
+    size_t i = 0;
+    for (; i + accumulators <= size; i += accumulators) {
+        for (size_t k = 0; k < accumulators; ++k) {
+            acc[k] += arr[i + k];
+        }
+    }
+    for (; i < size; ++i) {
+        acc[0] += arr[i];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+// size must be > 0
+template <typename T>
+std::pair<T, T> minmax_unrolled(const T* arr, size_t size) {
+    T lo[accumulators]{arr[0], arr[0], arr[0], arr[0]};
+    T hi[accumulators]{arr[0], arr[0], arr[0], arr[0]};
+    size_t i = 1;
+    for (; i + accumulators <= size; i += accumulators) {
+        for (size_t k = 0; k < accumulators; ++k) {
+            lo[k] = arr[i + k] < lo[k] ? arr[i + k] : lo[k];
+            hi[k] = arr[i + k] > hi[k] ? arr[i + k] : hi[k];
+        }
+    }
+    for (; i < size; ++i) {
+        lo[0] = arr[i] < lo[0] ? arr[i] : lo[0];
+        hi[0] = arr[i] > hi[0] ? arr[i] : hi[0];
+    }
+    for (size_t k = 1; k < accumulators; ++k) {
+        lo[0] = lo[k] < lo[0] ? lo[k] : lo[0];
+        hi[0] = hi[k] > hi[0] ? hi[k] : hi[0];
+    }
+    return {lo[0], hi[0]};
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+// Each AVX2 register holds 8 ints/floats or 4 doubles. Traits map the same algorithm onto the right intrinsics.
+// Functions using AVX2 instructions have to be compiled with target("avx2") attribute as the rest of the
+// program is compiled for the baseline x86-64 instruction set.
+template <typename T>
+struct Avx2;
+
+template <>
+struct Avx2<int> {
+    using reg = __m256i;
+    static constexpr size_t lanes = 8;
+    __attribute__((target("avx2"))) static reg zero() { return _mm256_setzero_si256(); }
+    __attribute__((target("avx2"))) static reg broadcast(int n) { return _mm256_set1_epi32(n); }
+    __attribute__((target("avx2"))) static reg load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    __attribute__((target("avx2"))) static void store(int* p, reg r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+    __attribute__((target("avx2"))) static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    __attribute__((target("avx2"))) static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    __attribute__((target("avx2"))) static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+};
+
+template <>
+struct Avx2<float> {
+    using reg = __m256;
+    static constexpr size_t lanes = 8;
+    __attribute__((target("avx2"))) static reg zero() { return _mm256_setzero_ps(); }
+    __attribute__((target("avx2"))) static reg broadcast(float f) { return _mm256_set1_ps(f); }
+    __attribute__((target("avx2"))) static reg load(const float* p) { return _mm256_loadu_ps(p); }
+    __attribute__((target("avx2"))) static void store(float* p, reg r) { _mm256_storeu_ps(p, r); }
+    __attribute__((target("avx2"))) static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    __attribute__((target("avx2"))) static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    __attribute__((target("avx2"))) static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+};
+
+template <>
+struct Avx2<double> {
+    using reg = __m256d;
+    static constexpr size_t lanes = 4;
+    __attribute__((target("avx2"))) static reg zero() { return _mm256_setzero_pd(); }
+    __attribute__((target("avx2"))) static reg broadcast(double d) { return _mm256_set1_pd(d); }
+    __attribute__((target("avx2"))) static reg load(const double* p) { return _mm256_loadu_pd(p); }
+    __attribute__((target("avx2"))) static void store(double* p, reg r) { _mm256_storeu_pd(p, r); }
+    __attribute__((target("avx2"))) static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    __attribute__((target("avx2"))) static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    __attribute__((target("avx2"))) static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+};
+
+// Two registers are used as accumulators so two independent vector additions are in flight in each iteration.
+template <typename T>
+__attribute__((target("avx2")))
+T sum_avx2(const T* arr, size_t size) {
+    using V = Avx2<T>;
+    auto acc0 = V::zero();
+    auto acc1 = V::zero();
+    size_t i = 0;
+    for (; i + 2 * V::lanes <= size; i += 2 * V::lanes) {
+        acc0 = V::add(acc0, V::load(arr + i));
+        acc1 = V::add(acc1, V::load(arr + i + V::lanes));
+    }
+
+    T lanes[V::lanes];
+    V::store(lanes, V::add(acc0, acc1));
+    T sum{};
+    for (size_t k = 0; k < V::lanes; ++k) {
+        sum += lanes[k];
+    }
+    for (; i < size; ++i) {
+        sum += arr[i];
+    }
+    return sum;
+}
+
+// size must be > 0
+template <typename T>
+__attribute__((target("avx2")))
+std::pair<T, T> minmax_avx2(const T* arr, size_t size) {
+    using V = Avx2<T>;
+    auto lo = V::broadcast(arr[0]);
+    auto hi = lo;
+    size_t i = 0;
+    for (; i + V::lanes <= size; i += V::lanes) {
+        auto r = V::load(arr + i);
+        lo = V::min(lo, r);
+        hi = V::max(hi, r);
+    }
+
+    T loLanes[V::lanes];
+    T hiLanes[V::lanes];
+    V::store(loLanes, lo);
+    V::store(hiLanes, hi);
+    std::pair<T, T> ret{loLanes[0], hiLanes[0]};
+    for (size_t k = 1; k < V::lanes; ++k) {
+        ret.first = loLanes[k] < ret.first ? loLanes[k] : ret.first;
+        ret.second = hiLanes[k] > ret.second ? hiLanes[k] : ret.second;
+    }
+    for (; i < size; ++i) {
+        ret.first = arr[i] < ret.first ? arr[i] : ret.first;
+        ret.second = arr[i] > ret.second ? arr[i] : ret.second;
+    }
+    return ret;
+}
+
+// __builtin_cpu_supports queries CPUID; result is cached in a function-local static.
+bool has_avx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+template <typename T>
+T sum(const T* arr, size_t size) {
+    return has_avx2() ? sum_avx2(arr, size) : sum_unrolled(arr, size);
+}
+
+template <typename T>
+std::pair<T, T> minmax(const T* arr, size_t size) {
+    return has_avx2() ? minmax_avx2(arr, size) : minmax_unrolled(arr, size);
+}
+
+#else
+
+template <typename T>
+T sum(const T* arr, size_t size) {
+    return sum_unrolled(arr, size);
+}
+
+template <typename T>
+std::pair<T, T> minmax(const T* arr, size_t size) {
+    return minmax_unrolled(arr, size);
+}
+
+#endif
+
+} // namespace simd
+
+// Generic (scalar) versions. Used as a fallback for types which are not vectorized.
 template <typename T>
-T arrSum(T* arr, size_t size) {
+T arrSumScalar(const T* arr, size_t size) {
     T sum = 0;
     for (size_t i = 0; i < size; ++i) {
         sum += arr[i];
@@ -50,9 +462,10 @@ T arrSum(T* arr, size_t size) {
 }
 
 template <typename T>
-T arrMax(T* arr, size_t size) {
+T arrMaxScalar(const T* arr, size_t size) {
     T max = arr[0];
-    for (size_t i = 0; i < size; ++i) {
+    // arr[0] is already in max, no need to compare it with itself
+    for (size_t i = 1; i < size; ++i) {
         if (arr[i] > max) {
             max = arr[i];
         }
@@ -61,11 +474,10 @@ T arrMax(T* arr, size_t size) {
     return max;
 }
 
-// return min and max element in array
 template<typename T>
-std::pair<T,T> arrMinMax(T *arr, size_t size){
+std::pair<T,T> arrMinMaxScalar(const T* arr, size_t size){
     std::pair<T, T> ret{arr[0], arr[0]};
-    for (size_t i = 0; i < size; ++i) {
+    for (size_t i = 1; i < size; ++i) {
         if (arr[i] < ret.first) {
             ret.first = arr[i];
         }
@@ -76,6 +488,85 @@ std::pair<T,T> arrMinMax(T *arr, size_t size){
     return ret;
 }
 
+// if constexpr (C++17) discards the branch which is not taken so the vectorized path is instantiated only
+// for int, float and double.
+template <typename T>
+T arrSum(const T* arr, size_t size) {
+    if constexpr (simd::is_vectorizable<T>::value) {
+        return simd::sum<T>(arr, size);
+    } else {
+        return arrSumScalar(arr, size);
+    }
+}
+
+template <typename T>
+T arrMax(const T* arr, size_t size) {
+    if constexpr (simd::is_vectorizable<T>::value) {
+        return simd::minmax<T>(arr, size).second;
+    } else {
+        return arrMaxScalar(arr, size);
+    }
+}
+
+// return min and max element in array
+template<typename T>
+std::pair<T,T> arrMinMax(const T* arr, size_t size){
+    if constexpr (simd::is_vectorizable<T>::value) {
+        return simd::minmax<T>(arr, size);
+    } else {
+        return arrMinMaxScalar(arr, size);
+    }
+}
+
+// Parallel overloads: each worker reduces its chunk with the (vectorized) sequential algorithm.
+template <typename T>
+T arrSum(const execution::ParallelPolicy& policy, const T* arr, size_t size) {
+    return execution::reduce(policy, arr, size,
+        [](const T* chunk, size_t n) { return arrSum(chunk, n); },
+        [](const T& a, const T& b) { return a + b; });
+}
+
+template<typename T>
+std::pair<T,T> arrMinMax(const execution::ParallelPolicy& policy, const T* arr, size_t size){
+    return execution::reduce(policy, arr, size,
+        [](const T* chunk, size_t n) { return arrMinMax(chunk, n); },
+        [](const std::pair<T, T>& a, const std::pair<T, T>& b) {
+            return std::pair<T, T>{b.first < a.first ? b.first : a.first, b.second > a.second ? b.second : a.second};
+        });
+}
+
+// Adding a small float to a large running sum loses its low-order bits. With millions of elements this error
+// accumulates. Kahan summation keeps the lost part in a separate compensation variable and adds it back in.
+template <typename T>
+T arrSumKahan(const T* arr, size_t size) {
+    static_assert(std::is_floating_point<T>::value, "Kahan summation is meaningful only for floating point types");
+    T sum{};
+    T compensation{};
+    for (size_t i = 0; i < size; ++i) {
+        T y = arr[i] - compensation;
+        T t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+    return sum;
+}
+
+// Pairwise summation: error grows with O(log n) instead of O(n) and, unlike Kahan, the leaves can still be vectorized.
+template <typename T>
+T arrSumPairwise(const T* arr, size_t size) {
+    static_assert(std::is_floating_point<T>::value, "Pairwise summation is meaningful only for floating point types");
+    constexpr size_t leafSize = 128;
+    if (size <= leafSize) {
+        if constexpr (simd::is_vectorizable<T>::value) {
+            return simd::sum(arr, size);
+        } else {
+            return simd::sum_unrolled(arr, size);
+        }
+    }
+    size_t half = size / 2;
+    return arrSumPairwise(arr, half) + arrSumPairwise(arr + half, size - half);
+}
+
 void demo() {
     auto maxValueInt1 = max(1, 2);
     std::cout << "maxValueInt1 = " << maxValueInt1 << std::endl;
@@ -100,6 +591,105 @@ void demo() {
     std::cout << "pair.first = " << pair.first << ", pair.second = " << pair.second << std::endl;
 }
 
+// Compares generic and vectorized reductions over arrays which fit in L1 (32 KB), L2, L3 and those which
+// can be served only from DRAM. Each size is repeated so that roughly the same number of elements is processed.
+// Build in Release mode to get meaningful numbers (Debug build uses -O0).
+template <typename T, typename Function>
+double benchmark_ns_per_element(Function f, std::vector<T>& v, size_t reps) {
+    volatile T sink{};
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < reps; ++r) {
+        sink = f(v.data(), v.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(reps) * v.size());
+}
+
+template <typename T>
+void benchmark_type(const char* typeName) {
+    const size_t sizes[] = {
+        4 * 1024 / sizeof(T),           // L1
+        256 * 1024 / sizeof(T),         // L2
+        4 * 1024 * 1024 / sizeof(T),    // L3
+        256 * 1024 * 1024 / sizeof(T)   // DRAM
+    };
+    const size_t elementsPerSize = 256 * 1024 * 1024 / sizeof(T);
+
+    for (auto size : sizes) {
+        std::vector<T> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<T>(i % 1000);
+        }
+        size_t reps = std::max<size_t>(1, elementsPerSize / size);
+
+        auto scalarSum = benchmark_ns_per_element<T>(arrSumScalar<T>, v, reps);
+        auto simdSum = benchmark_ns_per_element<T>([](T* arr, size_t n) { return arrSum(arr, n); }, v, reps);
+        auto scalarMinMax = benchmark_ns_per_element<T>([](T* arr, size_t n) { return arrMinMaxScalar(arr, n).second; }, v, reps);
+        auto simdMinMax = benchmark_ns_per_element<T>([](T* arr, size_t n) { return arrMinMax(arr, n).second; }, v, reps);
+
+        std::cout << typeName << ", " << size * sizeof(T) / 1024 << " KB: "
+            << "sum " << scalarSum << " -> " << simdSum << " ns/element, "
+            << "minmax " << scalarMinMax << " -> " << simdMinMax << " ns/element" << std::endl;
+    }
+}
+
+void benchmark() {
+    benchmark_type<int>("int");
+    benchmark_type<float>("float");
+    benchmark_type<double>("double");
+
+    // Precision of float sums
+    std::vector<float> v(10000000, 0.1f);
+    std::cout << "float sum of 10M x 0.1: naive = " << arrSumScalar(v.data(), v.size())
+        << ", vectorized = " << arrSum(v.data(), v.size())
+        << ", pairwise = " << arrSumPairwise(v.data(), v.size())
+        << ", Kahan = " << arrSumKahan(v.data(), v.size()) << std::endl;
+}
+
+
+// Measures how parallel arrSum and arrMinMax scale from 1 to N threads on an array which is far larger than caches.
+// Once all memory channels are saturated adding more threads will not help.
+void parallel_benchmark() {
+    const size_t size = 64 * 1024 * 1024;
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // 1, 2, 4, ... and finally all hardware threads
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (auto threads : threadCounts) {
+        execution::ThreadPool pool(threads);
+        execution::ParallelPolicy par{pool};
+        // Uninitialized (unlike std::vector<float>(size) which zero-fills it on this thread) so the first write to
+        // each page is done by parallel_fill() on the worker which later reads it. Allocated for each pool as pages
+        // are placed only once.
+        std::unique_ptr<float[]> v(new float[size]);
+        execution::parallel_fill(par, v.get(), size, 1.0f);
+
+        auto start = std::chrono::steady_clock::now();
+        auto sum = arrSum(par, v.get(), size);
+        auto mid = std::chrono::steady_clock::now();
+        auto minMax = arrMinMax(par, v.get(), size);
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << threads << " thread(s): "
+            << "arrSum = " << sum << " in " << std::chrono::duration<double, std::milli>(mid - start).count() << " ms, "
+            << "arrMinMax = (" << minMax.first << ", " << minMax.second << ") in "
+            << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
+    }
+
+    // Any associative operator can be used, not only the ones provided above.
+    execution::ThreadPool pool;
+    execution::ParallelPolicy par{pool};
+    unsigned bits[] = {0x1, 0x2, 0x4, 0x8, 0x10};
+    auto orAll = execution::reduce(par, bits, 5, 0u, [](unsigned a, unsigned b) { return a | b; });
+    std::cout << "orAll = " << orAll << std::endl;
+}
+
 } // namespace
 
 //
@@ -277,6 +867,11 @@ T sum(T* arr, size_t size) {
     return sum;
 }
 
+template<typename T>
+T sum(const execution::ParallelPolicy& policy, T* arr, size_t size) {
+    return execution::reduce(policy, arr, size, T{}, [](const T& a, const T& b) { return a + b; });
+}
+
 // we can use reference to array and non-type template args we can pass an array to a function without specifying its size.
 // This is used by standard library to implement global functions std::begin() and std::end() for arrays.
 template<typename T, int size>
@@ -315,6 +910,10 @@ void demo(){
     auto sumVal1 = sum<int>(arrInt, 3);
     std::cout << "sumVal1 = " << sumVal1 << std::endl;
 
+    execution::ThreadPool pool(2);
+    auto sumVal3 = sum(execution::ParallelPolicy{pool}, arrInt, 3);
+    std::cout << "sumVal3 = " << sumVal3 << std::endl;
+
     // reference to array
     int (&refArrInt)[3] = arrInt;
 
@@ -632,6 +1231,188 @@ void demo(){
 }
 } // namespace
 
+// Expression templates
+//
+// Integer::operator+ style arithmetic returns a new object from every operator. For vectors this means that
+// d = a + b * c creates a temporary vector for b * c, another one for a + (b * c) and makes a separate pass over
+// memory for each of them.
+// With expression templates operators don't compute anything. They return a lightweight object which only remembers
+// its operands and the operation; its type (e.g. Add<Vec, Mul<Vec, Vec>>) describes the whole expression.
+// The actual computation happens when the expression is assigned to a Vec: a single loop evaluates
+// d[i] = a[i] + b[i] * c[i] without temporaries, and because everything is inlined the compiler can vectorize it.
+namespace expression_templates {
+
+// CRTP base: lets operators accept any expression, but nothing else.
+template <typename E>
+struct VecExpr {
+    const E& self() const {
+        return static_cast<const E&>(*this);
+    }
+};
+
+template <typename T>
+class Vec : public VecExpr<Vec<T>> {
+    std::vector<T> data_;
+public:
+    using value_type = T;
+
+    explicit Vec(size_t size, T value = T{}) : data_(size, value) {}
+
+    // Evaluation of an expression: one pass, no temporaries
+    template <typename E>
+    Vec(const VecExpr<E>& expr) : data_(expr.self().size()) {
+        assign(expr.self());
+    }
+
+    template <typename E>
+    Vec& operator=(const VecExpr<E>& expr) {
+        data_.resize(expr.self().size());
+        assign(expr.self());
+        return *this;
+    }
+
+    size_t size() const {
+        return data_.size();
+    }
+
+    T operator[](size_t i) const {
+        return data_[i];
+    }
+
+    T& operator[](size_t i) {
+        return data_[i];
+    }
+
+private:
+    template <typename E>
+    void assign(const E& expr) {
+        T* out = data_.data();
+        const size_t n = data_.size();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = expr[i];
+        }
+    }
+};
+
+// Vectors are held by reference (they outlive the expression), sub-expressions by value (they are temporaries).
+// Note: auto e = a + b; is fine while a and b exist but the expression must not outlive them.
+template <typename E>
+struct operand {
+    using type = const E;
+};
+
+template <typename T>
+struct operand<Vec<T>> {
+    using type = const Vec<T>&;
+};
+
+template <typename L, typename R, typename Op>
+class BinaryExpr : public VecExpr<BinaryExpr<L, R, Op>> {
+    typename operand<L>::type l_;
+    typename operand<R>::type r_;
+public:
+    using value_type = typename L::value_type;
+
+    BinaryExpr(const L& l, const R& r) : l_(l), r_(r) {
+        assert(l.size() == r.size());
+    }
+
+    size_t size() const {
+        return l_.size();
+    }
+
+    value_type operator[](size_t i) const {
+        return Op::apply(l_[i], r_[i]);
+    }
+};
+
+struct Plus {
+    template <typename T>
+    static T apply(T a, T b) {
+        return a + b;
+    }
+};
+
+struct Minus {
+    template <typename T>
+    static T apply(T a, T b) {
+        return a - b;
+    }
+};
+
+struct Multiplies {
+    template <typename T>
+    static T apply(T a, T b) {
+        return a * b;
+    }
+};
+
+template <typename L, typename R>
+BinaryExpr<L, R, Plus> operator+(const VecExpr<L>& l, const VecExpr<R>& r) {
+    return {l.self(), r.self()};
+}
+
+template <typename L, typename R>
+BinaryExpr<L, R, Minus> operator-(const VecExpr<L>& l, const VecExpr<R>& r) {
+    return {l.self(), r.self()};
+}
+
+template <typename L, typename R>
+BinaryExpr<L, R, Multiplies> operator*(const VecExpr<L>& l, const VecExpr<R>& r) {
+    return {l.self(), r.self()};
+}
+
+// Classic implementation for comparison: every operator allocates and fills a new vector.
+template <typename T>
+class NaiveVec {
+    std::vector<T> data_;
+public:
+    explicit NaiveVec(size_t size, T value = T{}) : data_(size, value) {}
+
+    size_t size() const {
+        return data_.size();
+    }
+
+    T operator[](size_t i) const {
+        return data_[i];
+    }
+
+    NaiveVec operator+(const NaiveVec& other) const {
+        NaiveVec result(size());
+        for (size_t i = 0; i < size(); ++i) {
+            result.data_[i] = data_[i] + other.data_[i];
+        }
+        return result;
+    }
+
+    NaiveVec operator*(const NaiveVec& other) const {
+        NaiveVec result(size());
+        for (size_t i = 0; i < size(); ++i) {
+            result.data_[i] = data_[i] * other.data_[i];
+        }
+        return result;
+    }
+};
+
+void demo() {
+    const size_t size = 10000000;
+    Vec<double> a(size, 1.0), b(size, 2.0), c(size, 3.0), d(size);
+    NaiveVec<double> na(size, 1.0), nb(size, 2.0), nc(size, 3.0);
+
+    auto start = std::chrono::steady_clock::now();
+    NaiveVec<double> nd = na + nb * nc; // two temporaries, two loops
+    auto mid = std::chrono::steady_clock::now();
+    d = a + b * c; // one loop
+    auto end = std::chrono::steady_clock::now();
+
+    assert(d[size - 1] == nd[size - 1]);
+    std::cout << "d[0] = " << d[0] << std::endl; // 7
+    std::cout << "NaiveVec: " << std::chrono::duration<double, std::milli>(mid - start).count() << " ms, "
+        << "Vec: " << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
+}
+
+} // namespace expression_templates
+
 // Variadic Templates
 // - functions and classes that can accept arbitrary number of arguments
 // - in C printf() can accept any number of arguments; internally, it's implemented through macros =>
@@ -873,37 +1654,475 @@ void show_solution(){
     // ~Integer() // destroying n
 }
 
-void demo(){
-    // show_problem();
-    show_solution();
-}
+// Type-indexed dispatch
+//
+// Print2..Print10 peel off one argument per (generated) function. A pack expansion handles a whole parameter pack
+// in a single expression: index_of() finds a type's position with a C++17 fold expression and
+// {&invoke<Handler, Messages>...} generates, at compile time, a table with one entry per type in the same order.
+//
+// Use case: messages arrive with a runtime type tag. Instead of a chain of ifs (O(N) comparisons) or a virtual
+// call on a heap allocated object, the tag is used as an index into a jump table - an array of function pointers,
+// one per message type, each of which casts the payload back to its type and calls the handler overload for it.
+namespace type_dispatch {
+
+// Position of T in Ts... Fold over comma operator visits types left to right and stops counting at the first match.
+template <typename T, typename... Ts>
+constexpr uint32_t index_of() {
+    uint32_t index = 0;
+    bool found = false;
+    ((found = found || std::is_same<T, Ts>::value, index += found ? 0 : 1), ...);
+    return index;
 }
 
-// Complete Modern C++ (C++11/14/17) course by Umar Lone
-// https://www.udemy.com/course/beg-modern-cpp/
+// Envelope holds any of Messages in place (no heap) together with its type tag.
+// Messages have to be trivially copyable so envelopes can be copied around (e.g. through queues) as plain bytes.
+template <typename... Messages>
+class Envelope {
+    static_assert((std::is_trivially_copyable<Messages>::value && ...), "Messages must be trivially copyable");
 
-// Create a factory method that creates an instance of some type T, initializes it with arguments and returns the instance.
-// It should work with any type that accepts arbitrary number of arguments.
-// Here are some usage examples of the factory.
-//
-// Employee * emp = CreateObject<Employee>(
-// "Bob",    //Name
-// 101,      //Id
-// 1000) ;   //Salary
-//
-// Contact *p = CreateObject<Contact>(
-// "Joey",                //Name
-// 987654321,             //Phone number
-// "Boulevard Road, Sgr", //Address
-// "joey@poash.com") ;    //Email
+    uint32_t tag_;
+    alignas(Messages...) unsigned char payload_[std::max({sizeof(Messages)...})];
 
-namespace assignment1 {
+    template <typename Handler, typename T>
+    static void invoke(Handler& handler, const void* payload) {
+        handler(*static_cast<const T*>(payload));
+    }
+
+    explicit Envelope(uint32_t tag) : tag_(tag) {}
+
+    template <typename T>
+    static std::optional<Envelope> from_bytes(const void* bytes, size_t size) {
+        if (size != sizeof(T)) {
+            return std::nullopt;
+        }
+        Envelope envelope(tag_of<T>);
+        std::memcpy(envelope.payload_, bytes, sizeof(T));
+        return envelope;
+    }
+
+public:
+    template <typename T>
+    static constexpr uint32_t tag_of = index_of<T, Messages...>();
+
+    template <typename T>
+    explicit Envelope(const T& message) : tag_(tag_of<T>) {
+        static_assert(tag_of<T> < sizeof...(Messages), "T is not one of the registered message types");
+        new (payload_) T(message);
+    }
+
+    // Envelope for a message which arrives as a runtime type tag and raw bytes (e.g. from a socket or a log).
+    // Messages are trivially copyable so the bytes are copied in as they are. Same jump table approach as
+    // Dispatch(): the tag selects the builder for its type, which checks the size. Empty if the tag is unknown or
+    // the size doesn't match the tag's type.
+    static std::optional<Envelope> FromBytes(uint32_t tag, const void* bytes, size_t size) {
+        static constexpr std::optional<Envelope> (*table[])(const void*, size_t) = {&from_bytes<Messages>...};
+        if (tag >= sizeof...(Messages)) {
+            return std::nullopt;
+        }
+        return table[tag](bytes, size);
+    }
+
+    uint32_t Tag() const {
+        return tag_;
+    }
+
+    // bytes of the message (Size() of them), for sending it with its tag
+    const void* Bytes() const {
+        return payload_;
+    }
+
+    size_t Size() const {
+        static constexpr size_t sizes[] = {sizeof(Messages)...};
+        return sizes[tag_];
+    }
+
+    // Handler must have operator() overload for every message type; missing one is a compile-time error.
+    template <typename Handler>
+    void Dispatch(Handler& handler) const {
+        // One table per Handler type, built at compile time. Order of entries matches tag_of.
+        static constexpr void (*table[])(Handler&, const void*) = {&invoke<Handler, Messages>...};
+        table[tag_](handler, payload_);
+    }
+};
+
+struct Login {
+    int userId;
+};
+
+struct Logout {
+    int userId;
+};
+
+struct Chat {
+    int from;
+    char text[32];
+};
+
+using Message = Envelope<Login, Logout, Chat>;
+
+struct Handler {
+    int online{0};
+
+    void operator()(const Login& m) {
+        ++online;
+        std::cout << "Login: " << m.userId << std::endl;
+    }
+
+    void operator()(const Logout& m) {
+        --online;
+        std::cout << "Logout: " << m.userId << std::endl;
+    }
+
+    void operator()(const Chat& m) {
+        std::cout << "Chat from " << m.from << ": " << m.text << std::endl;
+    }
+};
+
+void demo() {
+    static_assert(Message::tag_of<Login> == 0, "");
+    static_assert(Message::tag_of<Chat> == 2, "");
+
+    std::vector<Message> messages{Message{Login{1}}, Message{Login{2}}, Message{Chat{1, "hello"}}, Message{Logout{2}}};
+
+    Handler handler;
+    for (const auto& message : messages) {
+        message.Dispatch(handler);
+    }
+    std::cout << "online = " << handler.online << std::endl; // 1
+
+    // (tag, bytes) as they would come over the wire
+    Chat chat{2, "bye"};
+    auto received = Message::FromBytes(Message::tag_of<Chat>, &chat, sizeof(chat));
+    assert(received && received->Size() == sizeof(Chat));
+    received->Dispatch(handler); // Chat from 2: bye
+    assert(!Message::FromBytes(3, &chat, sizeof(chat)));
+    assert(!Message::FromBytes(Message::tag_of<Login>, &chat, sizeof(chat)));
+}
+
+} // namespace type_dispatch
+
+// Single-write serialization
+//
+// Print10 makes one stream call per argument and per separator and recursion generates one function per arity.
+// Serialize expands all arguments in a single fold expression: it first adds up how many bytes each argument
+// needs, then writes all of them into one buffer (numbers with std::to_chars, no locale, no stream state) and finally
+// hands the whole buffer to the stream with a single write().
+// For numbers the number of bytes needed is bounded by the type alone so if there are no strings among the
+// arguments the buffer size is a compile-time constant and the buffer is a plain array on the stack.
+//
+// Format is a policy class. TextFormat writes integers, characters, bools and strings as Print10 does but floating
+// point numbers in the shortest form which reads back to the same value (std::to_chars) rather than with the
+// stream's default precision of 6 digits: 0.1 + 0.2 is 0.30000000000000004, not 0.3. BinaryFormat writes raw
+// values (strings as 32-bit length followed by characters).
+namespace serialization {
+
+template <typename T>
+constexpr bool is_string_like = std::is_convertible<const T&, std::string_view>::value;
+
+struct TextFormat {
+    template <typename T>
+    static constexpr bool has_static_size = std::is_arithmetic<T>::value;
+
+    // char, signed char and unsigned char are written as characters, as std::ostream does
+    template <typename T>
+    static constexpr bool is_character = std::is_same<T, char>::value || std::is_same<T, signed char>::value
+        || std::is_same<T, unsigned char>::value;
+
+    template <typename T>
+    static constexpr size_t static_size() {
+        if constexpr (std::is_same<T, bool>::value || is_character<T>) {
+            return 1;
+        } else if constexpr (std::is_integral<T>::value) {
+            return std::numeric_limits<T>::digits10 + 2; // all digits and sign
+        } else {
+            return std::numeric_limits<T>::max_digits10 + 8; // sign, point, exponent
+        }
+    }
+
+    static constexpr size_t separator_size = 2;
+    static constexpr size_t terminator_size = 1;
+
+    static char* separator(char* p) {
+        *p++ = ',';
+        *p++ = ' ';
+        return p;
+    }
+
+    static char* terminator(char* p) {
+        *p++ = '\n';
+        return p;
+    }
+
+    template <typename T>
+    static size_t size(const T& value) {
+        if constexpr (has_static_size<T>) {
+            return static_size<T>();
+        } else {
+            static_assert(is_string_like<T>, "TextFormat supports arithmetic and string types");
+            return std::string_view(value).size();
+        }
+    }
+
+    template <typename T>
+    static char* write(char* p, const T& value) {
+        if constexpr (std::is_same<T, bool>::value) {
+            *p++ = value ? '1' : '0'; // same as std::cout << value
+            return p;
+        } else if constexpr (is_character<T>) {
+            *p++ = static_cast<char>(value);
+            return p;
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            return std::to_chars(p, p + static_size<T>(), value).ptr;
+        } else {
+            std::string_view s(value);
+            std::memcpy(p, s.data(), s.size());
+            return p + s.size();
+        }
+    }
+};
+
+struct BinaryFormat {
+    template <typename T>
+    static constexpr bool has_static_size = std::is_arithmetic<T>::value;
+
+    template <typename T>
+    static constexpr size_t static_size() {
+        return sizeof(T);
+    }
+
+    static constexpr size_t separator_size = 0;
+    static constexpr size_t terminator_size = 0;
+
+    static char* separator(char* p) {
+        return p;
+    }
+
+    static char* terminator(char* p) {
+        return p;
+    }
+
+    template <typename T>
+    static size_t size(const T& value) {
+        if constexpr (has_static_size<T>) {
+            return sizeof(T);
+        } else {
+            static_assert(is_string_like<T>, "BinaryFormat supports arithmetic and string types");
+            return sizeof(uint32_t) + std::string_view(value).size();
+        }
+    }
+
+    template <typename T>
+    static char* write(char* p, const T& value) {
+        if constexpr (std::is_arithmetic<T>::value) {
+            std::memcpy(p, &value, sizeof(T));
+            return p + sizeof(T);
+        } else {
+            std::string_view s(value);
+            auto length = static_cast<uint32_t>(s.size());
+            std::memcpy(p, &length, sizeof(length));
+            std::memcpy(p + sizeof(length), s.data(), s.size());
+            return p + sizeof(length) + s.size();
+        }
+    }
+};
+
+template <typename Format, typename... Args>
+char* write_all(char* p, const Args&... args) {
+    [[maybe_unused]] bool first = true; // unused when there are no arguments
+    ((p = first ? p : Format::separator(p), first = false, p = Format::write(p, args)), ...);
+    return Format::terminator(p);
+}
+
+template <typename Format, typename... Args>
+void Serialize(std::ostream& os, const Args&... args) {
+    constexpr size_t separators = sizeof...(Args) > 0 ? (sizeof...(Args) - 1) * Format::separator_size : 0;
+
+    if constexpr ((Format::template has_static_size<Args> && ...)) {
+        constexpr size_t size = (Format::template static_size<Args>() + ... + 0) + separators + Format::terminator_size;
+        // zero-length array is ill-formed (BinaryFormat with no arguments writes nothing)
+        char buffer[size > 0 ? size : 1];
+        char* end = write_all<Format>(buffer, args...);
+        os.write(buffer, end - buffer);
+    } else {
+        // Strings are only known at runtime. Small output still fits into a stack buffer.
+        size_t capacity = (Format::size(args) + ... + 0) + separators + Format::terminator_size;
+        char stackBuffer[256];
+        std::unique_ptr<char[]> heapBuffer;
+        char* buffer = stackBuffer;
+        if (capacity > sizeof(stackBuffer)) {
+            heapBuffer.reset(new char[capacity]);
+            buffer = heapBuffer.get();
+        }
+        char* end = write_all<Format>(buffer, args...);
+        os.write(buffer, end - buffer);
+    }
+}
+
+template <typename... Args>
+void Print(const Args&... args) {
+    Serialize<TextFormat>(std::cout, args...);
+}
+
+// Stream buffer which discards everything; lets us measure formatting cost without terminal I/O.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+void benchmark() {
+    const int iterations = 1000000;
+    NullBuffer nullBuffer;
+    auto* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        Print10(i, "test", 3.14, 'c', 123456789L);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        Print(i, "test", 3.14, 'c', 123456789L);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout.rdbuf(coutBuffer);
+    std::cout << "Print10: " << std::chrono::duration<double, std::milli>(mid - start).count() << " ms, "
+        << "serialization::Print: " << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
+}
+
+void demo() {
+    Print(1, "test", 3.14);
+    // Output:
+    // 1, test, 3.14
+
+    // Only numbers => buffer size is known at compile time
+    Print(1, 2.5f, 'x', true);
+    // Output:
+    // 1, 2.5, x, 1
+
+    std::ostringstream os;
+    Serialize<BinaryFormat>(os, 1, std::string{"test"}, 3.14);
+    std::cout << "binary size = " << os.str().size() << std::endl; // 4 + (4 + 4) + 8 = 20
+}
+
+} // namespace serialization
+
+void demo(){
+    // show_problem();
+    show_solution();
+    // type_dispatch::demo();
+    // serialization::demo();
+    // serialization::benchmark();
+}
+}
+
+// Complete Modern C++ (C++11/14/17) course by Umar Lone
+// https://www.udemy.com/course/beg-modern-cpp/
+
+// Create a factory method that creates an instance of some type T, initializes it with arguments and returns the instance.
+// It should work with any type that accepts arbitrary number of arguments.
+// Here are some usage examples of the factory.
+//
+// Employee * emp = CreateObject<Employee>(
+// "Bob",    //Name
+// 101,      //Id
+// 1000) ;   //Salary
+//
+// Contact *p = CreateObject<Contact>(
+// "Joey",                //Name
+// 987654321,             //Phone number
+// "Boulevard Road, Sgr", //Address
+// "joey@poash.com") ;    //Email
+
+namespace assignment1 {
 
 template<typename TObject, typename ...Params>
 TObject* CreateObject(Params...args){
     return new TObject(args...);
 }
 
+// CreateObject copies its arguments (they are passed by value) and every object is a separate heap allocation which
+// caller has to delete.
+//
+// ObjectPool<T> allocates memory for many objects at once, in slabs (slab_pool::SlabPool). A destroyed object's slot
+// is put into a free list and reused by the next Create, so once the pool has warmed up creating and destroying
+// objects does not call malloc/free at all.
+// Create returns a Handle - unique_ptr with a deleter which destroys the object and returns its slot to the pool.
+//
+// Pool is not thread-safe: a pool and handles created from it should be used by a single thread.
+template <typename T, size_t slabSize = 256>
+class ObjectPool {
+    slab_pool::SlabPool<T, slabSize> slots_;
+    size_t live_{0};
+
+    void destroy(T* p) {
+        p->~T();
+        slots_.Deallocate(p);
+        --live_;
+    }
+
+public:
+    struct Deleter {
+        ObjectPool* pool;
+        void operator()(T* p) const {
+            pool->destroy(p);
+        }
+    };
+
+    using Handle = std::unique_ptr<T, Deleter>;
+
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Arguments are perfectly forwarded to T's constructor: temporaries are moved, lvalues are copied only once.
+    template <typename... Params>
+    Handle Create(Params&&... args) {
+        void* slot = slots_.Allocate();
+        T* p;
+        try {
+            p = new (slot) T(std::forward<Params>(args)...);
+        } catch (...) {
+            slots_.Deallocate(slot);
+            throw;
+        }
+        ++live_;
+        return Handle(p, Deleter{this});
+    }
+
+    size_t Live() const {
+        return live_;
+    }
+
+    size_t Capacity() const {
+        return slots_.Capacity();
+    }
+
+    // Bulk release: returns memory of all slabs to the system at once instead of freeing objects one by one.
+    // All objects created from the pool must have been destroyed.
+    void Release() {
+        assert(live_ == 0);
+        slots_.Release();
+    }
+};
+
+// Each type gets its own pool.
+template <typename TObject>
+ObjectPool<TObject>& PoolFor() {
+    static ObjectPool<TObject> pool;
+    return pool;
+}
+
+template <typename TObject, typename ...Params>
+typename ObjectPool<TObject>::Handle Create(Params&&... args) {
+    return PoolFor<TObject>().Create(std::forward<Params>(args)...);
+}
+
 class Employee {
 public:
     Employee(std::string name, int id, int salary) {
@@ -933,6 +2152,58 @@ void demo() {
         "joey@poash.com") ;    //Email
 
     // Contact: Joey, 987654321, Boulevard Road, Sgr, joey@poash.com
+
+    delete emp;
+    delete p;
+
+    {
+        auto employee = Create<Employee>("Alice", 102, 2000);
+        auto contact = Create<Contact>("Joey", 987654321, "Boulevard Road, Sgr", "joey@poash.com");
+        std::cout << "live employees = " << PoolFor<Employee>().Live() << std::endl; // 1
+    }
+    // handles went out of scope and returned their slots
+    std::cout << "live employees = " << PoolFor<Employee>().Live() << std::endl; // 0
+    PoolFor<Employee>().Release();
+    PoolFor<Contact>().Release();
+}
+
+struct Record {
+    std::string name;
+    int id;
+    int salary;
+    Record(std::string name, int id, int salary) : name(std::move(name)), id(id), salary(salary) {}
+};
+
+// Many short-lived objects: one at a time and in batches which are alive at the same time.
+void benchmark() {
+    const int count = 1000000;
+    const int batch = 1000;
+    long long checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i += batch) {
+        std::vector<std::unique_ptr<Record>> records;
+        records.reserve(batch);
+        for (int j = 0; j < batch; ++j) {
+            records.emplace_back(new Record("name", i + j, 1000));
+            checksum += records.back()->id;
+        }
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i += batch) {
+        std::vector<ObjectPool<Record>::Handle> records;
+        records.reserve(batch);
+        for (int j = 0; j < batch; ++j) {
+            records.push_back(Create<Record>("name", i + j, 1000));
+            checksum -= records.back()->id;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    PoolFor<Record>().Release();
+
+    assert(checksum == 0);
+    std::cout << "new/delete: " << std::chrono::duration<double, std::milli>(mid - start).count() << " ms, "
+        << "pool: " << std::chrono::duration<double, std::milli>(end - mid).count() << " ms" << std::endl;
 }
 
 }
@@ -990,45 +2261,281 @@ namespace solution {
 
 // compiler will create only classes for those types that template is instantiated for.
 // Only those member functions that are invoked will be instantiated.
-template <typename T>
+//
+// Elements live in raw (uninitialized) storage and are constructed only when pushed so T does not need to be
+// default constructible and no work is done for unused slots. When storage is full its capacity is doubled
+// which makes Push amortized O(1).
+// The first InlineCapacity elements are stored inside the Stack object itself (small buffer) so small stacks
+// don't allocate at all. Larger stacks get their memory from Allocator.
+template <typename T, size_t InlineCapacity = 0, typename Allocator = std::allocator<T>>
 class Stack {
-    T buff_[512];
-    int top_{-1};
+    using Traits = std::allocator_traits<Allocator>;
+
+    Allocator alloc_;
+    T* data_{InlineCapacity > 0 ? inline_data() : nullptr};
+    size_t size_{0};
+    size_t capacity_{InlineCapacity};
+    alignas(T) unsigned char inline_[InlineCapacity > 0 ? InlineCapacity * sizeof(T) : 1];
+
+    T* inline_data() {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    bool is_inline() const {
+        return InlineCapacity > 0 && reinterpret_cast<const unsigned char*>(data_) == inline_;
+    }
+
+    void destroy_all() {
+        for (size_t i = 0; i < size_; ++i) {
+            Traits::destroy(alloc_, data_ + i);
+        }
+        size_ = 0;
+    }
+
+    void release() {
+        if (data_ && !is_inline()) {
+            Traits::deallocate(alloc_, data_, capacity_);
+        }
+        data_ = InlineCapacity > 0 ? inline_data() : nullptr;
+        capacity_ = InlineCapacity;
+    }
+
+    // Moves existing elements into a new block of memory. If construct is given, it is called first to create
+    // the new top element in the new block; that way arguments which refer to an element of this stack stay valid.
+    template <typename Construct>
+    void reallocate(size_t newCapacity, Construct construct) {
+        T* newData = Traits::allocate(alloc_, newCapacity);
+        size_t constructed = 0;
+        try {
+            construct(newData + size_);
+            for (; constructed < size_; ++constructed) {
+                Traits::construct(alloc_, newData + constructed, std::move_if_noexcept(data_[constructed]));
+            }
+        } catch (...) {
+            for (size_t i = 0; i < constructed; ++i) {
+                Traits::destroy(alloc_, newData + i);
+            }
+            Traits::deallocate(alloc_, newData, newCapacity);
+            throw;
+        }
+
+        size_t size = size_;
+        destroy_all();
+        release();
+        data_ = newData;
+        size_ = size;
+        capacity_ = newCapacity;
+    }
+
+    size_t next_capacity() const {
+        return capacity_ == 0 ? 4 : 2 * capacity_;
+    }
+
+    // Takes over other's elements. alloc_ must be able to deallocate memory allocated by other.alloc_.
+    void steal(Stack&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (other.is_inline()) {
+            for (size_t i = 0; i < other.size_; ++i) {
+                Traits::construct(alloc_, data_ + i, std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.destroy_all();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = InlineCapacity > 0 ? other.inline_data() : nullptr;
+            other.size_ = 0;
+            other.capacity_ = InlineCapacity;
+        }
+    }
+
 public:
+    Stack() = default;
+
+    explicit Stack(const Allocator& alloc) : alloc_(alloc) {}
+
+    Stack(const Stack& other) : alloc_(Traits::select_on_container_copy_construction(other.alloc_)) {
+        try {
+            Reserve(other.size_);
+            for (size_t i = 0; i < other.size_; ++i) {
+                Traits::construct(alloc_, data_ + i, other.data_[i]);
+                ++size_;
+            }
+        } catch (...) {
+            // d-tor is not called for an object whose c-tor threw
+            destroy_all();
+            release();
+            throw;
+        }
+    }
+
+    Stack(Stack&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : alloc_(std::move(other.alloc_)) {
+        steal(std::move(other));
+    }
+
+    Stack& operator=(const Stack& other) {
+        if (this != &other) {
+            Stack copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    // Doesn't throw when memory can be handed over (allocators propagate or are always equal) and moving the
+    // elements of an inline buffer doesn't throw.
+    Stack& operator=(Stack&& other) noexcept((Traits::propagate_on_container_move_assignment::value
+        || Traits::is_always_equal::value) && std::is_nothrow_move_constructible<T>::value) {
+        if (this == &other) {
+            return *this;
+        }
+        destroy_all();
+        release();
+        if constexpr (Traits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+        } else if (!(alloc_ == other.alloc_)) {
+            // Our allocator can't free other's memory, elements have to be moved one by one.
+            Reserve(other.size_);
+            for (size_t i = 0; i < other.size_; ++i) {
+                Traits::construct(alloc_, data_ + i, std::move(other.data_[i]));
+                ++size_;
+            }
+            other.destroy_all();
+            return *this;
+        }
+        steal(std::move(other));
+        return *this;
+    }
+
+    ~Stack() {
+        destroy_all();
+        release();
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            reallocate(capacity, [](T*) {});
+        }
+    }
+
+    // Constructs element in place, directly from constructor arguments.
+    template <typename... Args>
+    T& Emplace(Args&&... args) {
+        if (size_ == capacity_) {
+            reallocate(next_capacity(), [&](T* p) { Traits::construct(alloc_, p, std::forward<Args>(args)...); });
+        } else {
+            Traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
     // T can be a user-defined type so we should pass it by const reference
     void Push(const T& elem) {
-        buff_[++top_] = elem;
+        Emplace(elem);
+    }
+
+    // Temporary objects are moved in, not copied
+    void Push(T&& elem) {
+        Emplace(std::move(elem));
     }
 
     void Pop() {
-        --top_;
+        assert(!IsEmpty());
+        Traits::destroy(alloc_, data_ + --size_);
     }
 
-    const T& Top() {
-        return buff_[top_];
+    // Removes top element and returns it. Element is moved out, not copied.
+    T PopTop() {
+        assert(!IsEmpty());
+        T top{std::move(data_[size_ - 1])};
+        Pop();
+        return top;
     }
 
-    bool IsEmpty() {
-        return top_ == -1;
+    const T& Top() const {
+        assert(!IsEmpty());
+        return data_[size_ - 1];
+    }
+
+    T& Top() {
+        assert(!IsEmpty());
+        return data_[size_ - 1];
+    }
+
+    bool IsEmpty() const {
+        return size_ == 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
     }
 };
 
 // class templates can accept non-type template arguments
+//
+// Storage is raw memory: an element is constructed when pushed and destroyed when popped, so slots above top_
+// are never constructed (creating Stack2<std::string, 512> does not create 512 empty strings).
+// Copy and move touch only live elements. If T is trivially copyable they are copied as a single block of bytes.
 template <typename T, int size>
 class Stack2 {
-    T buff_[size];
+    alignas(T) unsigned char buff_[size * sizeof(T)];
     int top_{-1};
+
+    T* data() {
+        return reinterpret_cast<T*>(buff_);
+    }
+
+    const T* data() const {
+        return reinterpret_cast<const T*>(buff_);
+    }
+
+    void clear() {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (int i = top_; i >= 0; --i) {
+                data()[i].~T();
+            }
+        }
+        top_ = -1;
+    }
+
+    // Stack must be empty. If T's copy/move constructor throws, already created elements are destroyed.
+    template <typename Source>
+    void construct_from(Source& other) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            std::memcpy(buff_, other.buff_, (other.top_ + 1) * sizeof(T));
+            top_ = other.top_;
+        } else {
+            try {
+                for (int i = 0; i <= other.top_; ++i) {
+                    if constexpr (std::is_const<Source>::value) {
+                        new (buff_ + i * sizeof(T)) T(other.data()[i]);
+                    } else {
+                        new (buff_ + i * sizeof(T)) T(std::move(other.data()[i]));
+                    }
+                    top_ = i;
+                }
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+    }
+
 public:
     // T can be a user-defined type so we should pass it by const reference
     void Push(const T& elem) {
-        buff_[++top_] = elem;
+        new (buff_ + (top_ + 1) * sizeof(T)) T(elem);
+        ++top_;
     }
 
     // We can define memeber function outside the class definition
     void Pop();
 
     const T& Top() {
-        return buff_[top_];
+        return data()[top_];
     }
 
     bool IsEmpty() {
@@ -1039,6 +2546,7 @@ public:
     // Return type does not need complete template type parameters as this definition is within the template class.
     // This is so called "shorthand notation" in which we don't need to specify template type parameters.
     // It can be used only if that type is inside class definition. It cannot be used outside the class.
+    // Since C++17 copy elision is guaranteed here: object is created directly in the caller, no copy or move is made.
     static Stack2 Create() {
         return Stack2<T, size>(); // temp object returned by value
     }
@@ -1051,10 +2559,34 @@ public:
     // Copy constructor; its argument uses the shorthand notation.
     // Long-hand notation can also be used but is not required.
     Stack2(const Stack2& other) {
-        for (int i = 0; i <= other.top_; ++i) {
-            buff_[i] = other.buff_[i];
+        construct_from(other);
+    }
+
+    // Move constructor; other is left empty.
+    Stack2(Stack2&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        construct_from(other);
+        other.clear();
+    }
+
+    Stack2& operator=(const Stack2& other) {
+        if (this != &other) {
+            clear();
+            construct_from(other);
+        }
+        return *this;
+    }
+
+    Stack2& operator=(Stack2&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            construct_from(other);
+            other.clear();
         }
-        top_ = other.top_;
+        return *this;
+    }
+
+    ~Stack2() {
+        clear();
     }
 };
 
@@ -1062,6 +2594,7 @@ public:
 // In templates, template parameters are part of the type, therefore we need to write Stack2<T, size>:
 template<typename T, int size>
 void Stack2<T, size>::Pop() {
+    data()[top_].~T();
     --top_;
 }
 
@@ -1071,6 +2604,170 @@ Stack2<T, size> Stack2<T, size>::Create2() {
     return Stack2<T, size>();
 }
 
+// Lock-free version of Stack2 which can be shared between producer and consumer threads.
+//
+// Capacity is fixed (size) as in Stack2 but slots are linked into two lists: list of used slots (the stack itself)
+// and list of free slots. Both are Treiber stacks: head is swapped with a single compare-and-swap (CAS) so no mutex
+// is needed and a stalled thread can't block others.
+//
+// ABA problem: thread A reads head = slot 5 (next = 3) and gets preempted; other threads pop 5, pop 3, push 5.
+// Head is again 5 so A's CAS would succeed and install 3, which is not in the list anymore.
+// To prevent this, head holds a 32-bit slot index and a 32-bit tag which is incremented on every change.
+// Both fit into a single 64-bit atomic so CAS fails if head was changed in the meantime, even if index is the same.
+//
+// Values are read while other threads might reuse the slot so they are stored in std::atomic<T>, which
+// requires T to be trivially copyable.
+template <typename T, int size>
+class ConcurrentStack2 {
+    static_assert(std::is_trivially_copyable<T>::value, "ConcurrentStack2 requires trivially copyable T");
+    static_assert(size > 0, "ConcurrentStack2 requires positive size");
+
+    static constexpr uint32_t nil = UINT32_MAX;
+
+    static uint64_t pack(uint32_t index, uint32_t tag) {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    static uint32_t index_of(uint64_t head) {
+        return static_cast<uint32_t>(head);
+    }
+
+    static uint32_t tag_of(uint64_t head) {
+        return static_cast<uint32_t>(head >> 32);
+    }
+
+    // Heads are written by all threads; keeping each in its own cache line avoids false sharing.
+    alignas(64) std::atomic<uint64_t> top_{pack(nil, 0)};
+    alignas(64) std::atomic<uint64_t> free_{pack(0, 0)};
+    alignas(64) std::atomic<uint32_t> next_[size];
+    std::atomic<T> buff_[size];
+
+    bool pop_slot(std::atomic<uint64_t>& head, uint32_t& index) {
+        uint64_t old = head.load(std::memory_order_acquire);
+        for (;;) {
+            index = index_of(old);
+            if (index == nil) {
+                return false;
+            }
+            // next_[index] might be changed concurrently if slot was already taken by another thread;
+            // in that case tag has changed and CAS below fails.
+            uint64_t desired = pack(next_[index].load(std::memory_order_relaxed), tag_of(old) + 1);
+            if (head.compare_exchange_weak(old, desired, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+
+    void push_slot(std::atomic<uint64_t>& head, uint32_t index) {
+        uint64_t old = head.load(std::memory_order_relaxed);
+        for (;;) {
+            next_[index].store(index_of(old), std::memory_order_relaxed);
+            if (head.compare_exchange_weak(old, pack(index, tag_of(old) + 1), std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+public:
+    ConcurrentStack2() {
+        for (int i = 0; i < size; ++i) {
+            next_[i].store(i + 1 < size ? i + 1 : nil, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentStack2(const ConcurrentStack2&) = delete;
+    ConcurrentStack2& operator=(const ConcurrentStack2&) = delete;
+
+    // Returns false if stack is full.
+    bool TryPush(const T& elem) {
+        uint32_t index;
+        if (!pop_slot(free_, index)) {
+            return false;
+        }
+        buff_[index].store(elem, std::memory_order_relaxed);
+        push_slot(top_, index);
+        return true;
+    }
+
+    // Returns false if stack is empty.
+    bool TryPop(T& elem) {
+        uint32_t index;
+        if (!pop_slot(top_, index)) {
+            return false;
+        }
+        elem = buff_[index].load(std::memory_order_relaxed);
+        push_slot(free_, index);
+        return true;
+    }
+
+    // Waits until there is a free slot.
+    void Push(const T& elem) {
+        while (!TryPush(elem)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Waits until there is an element. Unlike Stack2::Pop, returns the removed element: with several
+    // consumers Top() followed by Pop() would not necessarily refer to the same element.
+    T Pop() {
+        T elem;
+        while (!TryPop(elem)) {
+            std::this_thread::yield();
+        }
+        return elem;
+    }
+
+    // Returns a copy of the top element as it was at some moment during the call. Waits if stack is empty.
+    T Top() const {
+        for (;;) {
+            uint64_t head = top_.load(std::memory_order_acquire);
+            if (index_of(head) == nil) {
+                std::this_thread::yield();
+                continue;
+            }
+            T elem = buff_[index_of(head)].load(std::memory_order_relaxed);
+            // If head is unchanged, slot was not popped (and possibly reused) while we were reading it.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (top_.load(std::memory_order_relaxed) == head) {
+                return elem;
+            }
+        }
+    }
+
+    bool IsEmpty() const {
+        return index_of(top_.load(std::memory_order_acquire)) == nil;
+    }
+};
+
+// Stack2 protected by a mutex; baseline for concurrent_benchmark().
+template <typename T, int size>
+class LockedStack2 {
+    Stack2<T, size> stack_;
+    int count_{0};
+    std::mutex mutex_;
+public:
+    bool TryPush(const T& elem) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == size) {
+            return false;
+        }
+        stack_.Push(elem);
+        ++count_;
+        return true;
+    }
+
+    bool TryPop(T& elem) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stack_.IsEmpty()) {
+            return false;
+        }
+        elem = stack_.Top();
+        stack_.Pop();
+        --count_;
+        return true;
+    }
+};
+
 
 void show() {
 
@@ -1087,6 +2784,21 @@ void show() {
         }
     }
 
+    {
+        // Up to 4 strings are stored inside the stack object, 5th Push moves them to the heap.
+        Stack<std::string, 4> stack;
+        for (int i = 0; i < 5; ++i) {
+            stack.Emplace(3, static_cast<char>('a' + i)); // std::string(3, 'a')
+        }
+        std::string s{"moved in"};
+        stack.Push(std::move(s));
+        std::cout << "size = " << stack.Size() << ", capacity = " << stack.Capacity() << std::endl;
+
+        while (!stack.IsEmpty()) {
+            std::cout << stack.PopTop() << std::endl;
+        }
+    }
+
     {
         Stack<float> stack;
         stack.Push(1.);
@@ -1113,6 +2825,21 @@ void show() {
         }
     }
 
+    {
+        ConcurrentStack2<int, 10> stack;
+        std::thread producer([&stack] {
+            for (int i = 1; i <= 4; ++i) {
+                stack.Push(i);
+            }
+        });
+        int sum = 0;
+        for (int i = 0; i < 4; ++i) {
+            sum += stack.Pop();
+        }
+        producer.join();
+        std::cout << "sum of popped elements = " << sum << std::endl; // 10
+    }
+
     {
         // error: conversion from ‘Stack2<[...],10>’ to non-scalar type ‘Stack2<[...],9>’ requested
         // Stack2<int, 9> stack = Stack2<int, 10>::Create();
@@ -1137,6 +2864,131 @@ void show() {
         }
     }
 
+    {
+        // std::string is not trivially copyable so elements are copied/moved one by one.
+        auto stack = Stack2<std::string, 10>::Create();
+        stack.Push("one");
+        stack.Push("two");
+
+        Stack2<std::string, 10> copy(stack);
+        assert(copy.Top() == "two");
+        assert(stack.Top() == "two");
+
+        Stack2<std::string, 10> moved(std::move(stack));
+        assert(moved.Top() == "two");
+        assert(stack.IsEmpty());
+
+        stack = moved;
+        moved.Pop();
+        assert(moved.Top() == "one");
+        assert(stack.Top() == "two");
+
+        copy = std::move(moved);
+        assert(copy.Top() == "one");
+        assert(moved.IsEmpty());
+
+        // int is trivially copyable so live elements are copied with a single memcpy.
+        Stack2<int, 10> ints;
+        ints.Push(1);
+        ints.Push(2);
+        Stack2<int, 10> intsCopy(ints);
+        assert(intsCopy.Top() == 2);
+        intsCopy.Pop();
+        assert(intsCopy.Top() == 1);
+    }
+
+}
+
+// Fills and empties a small stack many times. Baselines are fixed capacity stacks:
+// problem::Stack which is an array of 512 ints and Stack2<std::string, 512>.
+// Checksum makes elements observable so the optimizer can't drop the whole loop.
+size_t checksum_of(int n) {
+    return static_cast<size_t>(n);
+}
+
+size_t checksum_of(const std::string& s) {
+    return s.size();
+}
+
+template <typename TStack, typename T>
+double benchmark_small_stack_ms(const T& value) {
+    const int iterations = 100000;
+    const int depth = 8;
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        TStack stack;
+        for (int j = 0; j < depth; ++j) {
+            stack.Push(value);
+        }
+        while (!stack.IsEmpty()) {
+            checksum += checksum_of(stack.Top());
+            stack.Pop();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "(checksum " << checksum << ") ";
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Each thread pushes and pops its own values on a shared stack. With more threads there is more contention on
+// the head; lock-free stack retries a CAS while locked stack makes threads wait for the mutex.
+template <typename TStack>
+double contended_ops_per_us(size_t threads) {
+    const int operations = 100000;
+    TStack stack;
+    std::atomic<long long> checksum{0};
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&stack, &checksum, t] {
+            long long sum = 0;
+            int value = 0;
+            for (int i = 0; i < operations; ++i) {
+                while (!stack.TryPush(static_cast<int>(t))) {
+                    std::this_thread::yield();
+                }
+                while (!stack.TryPop(value)) {
+                    std::this_thread::yield();
+                }
+                sum += value;
+            }
+            checksum += sum;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Every pushed value is popped exactly once.
+    long long expected = 0;
+    for (size_t t = 0; t < threads; ++t) {
+        expected += static_cast<long long>(t) * operations;
+    }
+    assert(checksum == expected);
+
+    return 2.0 * operations * threads / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void concurrent_benchmark() {
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        std::cout << threads << " thread(s): "
+            << "lock-free " << contended_ops_per_us<ConcurrentStack2<int, 1024>>(threads) << " ops/us, "
+            << "mutex " << contended_ops_per_us<LockedStack2<int, 1024>>(threads) << " ops/us" << std::endl;
+    }
+}
+
+void benchmark() {
+    std::cout << "int, fixed 512 array: " << benchmark_small_stack_ms<problem::Stack>(1) << " ms" << std::endl;
+    std::cout << "int, Stack<int>: " << benchmark_small_stack_ms<Stack<int>>(1) << " ms" << std::endl;
+    std::cout << "int, Stack<int, 16>: " << benchmark_small_stack_ms<Stack<int, 16>>(1) << " ms" << std::endl;
+
+    std::string value{"value"};
+    std::cout << "string, Stack2<std::string, 512>: " << benchmark_small_stack_ms<Stack2<std::string, 512>>(value) << " ms" << std::endl;
+    std::cout << "string, Stack<std::string>: " << benchmark_small_stack_ms<Stack<std::string>>(value) << " ms" << std::endl;
+    std::cout << "string, Stack<std::string, 16>: " << benchmark_small_stack_ms<Stack<std::string, 16>>(value) << " ms" << std::endl;
 }
 
 }
@@ -1173,15 +3025,21 @@ void defer_test(){
 void run() {
     std::cout << "templates_demo::run()" << std::endl;
     // introduction::demo();
+    // introduction::benchmark();
+    // introduction::parallel_benchmark();
     // template_arg_deduction::demo();
     // explicit_specialization::demo();
     // misc::defer_test();
     // non_type_template_arguments::demo();
     // perfect_forwarding::demo();
+    // expression_templates::demo();
     // variadic_templates::demo();
     // assignment1::demo();
+    // assignment1::benchmark();
     // class_templates::problem::show();
     class_templates::solution::show();
+    // class_templates::solution::benchmark();
+    // class_templates::solution::concurrent_benchmark();
 }
 
 }